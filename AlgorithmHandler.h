@@ -2,47 +2,14 @@
 #define ALGORITHM_HANDLER_H
 
 #include "shared.h"
+#include "PointLoader.h"
+#include "CancellationToken.h"
+#include "PolygonGenerator.h"
+#include "PolygonOptimizer.h"
+#include "ThreadClock.h"
+#include "Trace.h"
 
-void getPointsFromFile(std::string filepath, int& size, PointList& points, long& convexHullArea)
-{
-    //get number of lines
-    std::ifstream infile(filepath);
-    int linesCount = 0;
-    std::string line;
-
-    while(getline(infile, line))linesCount++;
-    int pointsCount = linesCount - 2;   //files always have 2 comments and then just points
-    size = pointsCount;
-
-    
-    //reset reading cursor
-    infile.clear();
-    infile.seekg(0);
-
-    //ignore first 2 lines
-    getline(infile, line);
-    getline(infile,line);
-
-    //get convex hull area from second line
-    convexHullArea = stol(   // we use stol instead of stoi because stoi return an integer and stol return a long
-        line.substr(
-            line.find("{\"area\": \"") + 10, 
-            line.find("\"}"))
-    );
-
-    //read points
-    int x,y;
-    for(int i = 0; getline(infile, line); i++)
-    {
-        int ignore;
-        std::istringstream iss(line);
-        iss >> ignore >> x >> y;
-        points.push_back(Point_2(x,y));
-    }
-
-    infile.close();
-    return;
-}
+#include <chrono>
 
 class AlgorithmHandler
 {
@@ -51,9 +18,52 @@ protected:
     PointList points;  
     int size;
     long convexHullArea;
+    uint64_t fingerprint;
+    Polygon_2 lastPolygon;  //the polygon the last run ended with
+    const CancellationToken* cancellation;  //handed to every generator and optimizer of a run, may be null
+    double generationTime;      //milliseconds spent in the generator of the last run
+    double optimizationTime;    //milliseconds spent in the optimizer of the last run
+    double generationCpuTime;   //milliseconds of thread CPU time spent in the generator of the last run
+    double optimizationCpuTime; //milliseconds of thread CPU time spent in the optimizer of the last run
+
+    // runs <generator> under the cancellation of the run, timing it as the generation phase
+    Polygon_2 generate(PolygonGenerator* generator)
+    {
+        generator->setCancellation(cancellation);
+        TraceSpan span("phase", "generation");
+
+        double cpuStart = threadCpuTime();
+        auto start = std::chrono::steady_clock::now();
+        Polygon_2 initial = generator->generatePolygon();
+        generationTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        generationCpuTime = threadCpuTime() - cpuStart;
+
+        return initial;
+    }
+
+    // runs <optimizer> under the cancellation of the run, timing it as the optimization phase. Its result becomes the last polygon
+    Polygon_2 optimize(PolygonOptimizer* optimizer)
+    {
+        optimizer->setCancellation(cancellation);
+        TraceSpan span("phase", "optimization");
+
+        double cpuStart = threadCpuTime();
+        auto start = std::chrono::steady_clock::now();
+        lastPolygon = optimizer->optimalPolygon();
+        optimizationTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        optimizationCpuTime = threadCpuTime() - cpuStart;
+
+        return lastPolygon;
+    }
 
 public:
-    AlgorithmHandler(std::string name): filename(name){getPointsFromFile(name, size, points, convexHullArea);};
+    AlgorithmHandler(): size(0), convexHullArea(0), fingerprint(0), cancellation(nullptr){resetTiming();};
+    AlgorithmHandler(std::string name): filename(name), cancellation(nullptr)
+    {
+        getPointsFromFile(name, size, points, convexHullArea);
+        fingerprint = fingerprintPoints(points);
+        resetTiming();
+    };
     virtual ~AlgorithmHandler(){};
 
     virtual double incrementalLocalSearch(OptimizationType type) = 0; 
@@ -64,6 +74,9 @@ public:
     virtual double onionAnnealing(OptimizationType type) = 0;  
     virtual double antColony(OptimizationType type) = 0;
 
+    // identifies the strategy and the parameters it would pick for the current instance, results are only reused under the same signature
+    virtual std::string parameterSignature() = 0;
+
     virtual void printFields()
     {
         std::cout << "filename: " << filename << std::endl;
@@ -71,14 +84,39 @@ public:
         std::cout << "convex hull area: " << convexHullArea << std::endl;
     }
 
+    const std::string& getFilename(){return filename;}
     int getSize(){return size;}
     long getCHullArea(){return convexHullArea;}
+    uint64_t getFingerprint(){return fingerprint;}
+    const Polygon_2& getLastPolygon(){return lastPolygon;}
+    void setLastPolygon(const Polygon_2& polygon){lastPolygon = polygon;}
+
+    void setCancellation(const CancellationToken* token){cancellation = token;}
+
+    double getGenerationTime(){return generationTime;}
+    double getOptimizationTime(){return optimizationTime;}
+    double getGenerationCpuTime(){return generationCpuTime;}
+    double getOptimizationCpuTime(){return optimizationCpuTime;}
+    void resetTiming(){generationTime = optimizationTime = generationCpuTime = optimizationCpuTime = 0;}
+
+    // copies the points of <dataset>, leaving it untouched for other handlers
+    void loadDataset(const Dataset& dataset)
+    {
+        filename = dataset.name;
+        size = dataset.size;
+        convexHullArea = dataset.convexHullArea;
+        fingerprint = dataset.fingerprint;
+        points.assign(dataset.points.begin(), dataset.points.end());
+    }
 
-    void resetFile(std::string newFile)
+    // takes over the points of an already parsed <dataset>, handing the previous points back to it
+    void resetDataset(Dataset& dataset)
     {
-        filename = newFile;
-        points.clear();
-        getPointsFromFile(newFile, size, points, convexHullArea);
+        filename = dataset.name;
+        size = dataset.size;
+        convexHullArea = dataset.convexHullArea;
+        fingerprint = dataset.fingerprint;
+        points.swap(dataset.points);
     }
     
 };
@@ -0,0 +1,199 @@
+#ifndef BATCH_EXECUTOR_H
+#define BATCH_EXECUTOR_H
+
+#include "shared.h"
+#include "AlgorithmHandler.h"
+#include "DatasetPipeline.h"
+#include "ResultLogger.h"
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <exception>
+
+// one run of a combination with one objective on one instance
+struct EvaluationTask
+{
+    int dataset;
+    Combination combination;
+    OptimizationType type;
+    int trial;  // repetition of the run, from 0 to trials-1
+    long cost;  // estimated cost of the run, the point count of the instance
+};
+
+typedef std::function<AlgorithmHandler*()> HandlerFactory;
+typedef std::function<RunResult(AlgorithmHandler&, const EvaluationTask&)> TaskRunner;
+typedef std::function<void(const EvaluationTask&, const RunResult&)> ResultCallback;
+typedef std::function<bool(const EvaluationTask&)> TaskFilter;
+
+/*
+    BatchExecutor runs every (file, combination, objective) triple of an input as a task on a pool of worker threads.
+    Tasks are sorted longest first and dealt round robin to per worker queues. A worker takes the longest task of its own queue,
+    and once it runs dry it steals the longest task left in any other queue, so the expensive runs always start first.
+    Every worker owns its own handler and gets a fresh copy of the instance for every task.
+*/
+class BatchExecutor
+{
+private:
+    int threads;
+    std::vector<std::deque<EvaluationTask>> queues;
+    std::vector<std::mutex> locks;
+
+    bool popOwn(int, EvaluationTask&);
+    bool steal(int, EvaluationTask&);
+
+public:
+    BatchExecutor(int threads): threads(std::max(threads, 1)), queues(std::max(threads, 1)), locks(std::max(threads, 1)){};
+
+    void loadAll(DatasetSource&, std::vector<Dataset>&);
+    void run(std::vector<Dataset>&, int, int, TaskFilter, HandlerFactory, TaskRunner, ResultCallback);
+};
+
+// parses every instance of <source> into <datasets>, spreading the files over the worker threads
+void BatchExecutor::loadAll(DatasetSource& source, std::vector<Dataset>& datasets)
+{
+    datasets.resize(source.count());
+
+    std::atomic<int> next(0);
+    std::exception_ptr failure;
+    std::mutex failureLock;
+
+    std::vector<std::thread> workers;
+    for(int w = 0; w < threads; w++)
+    {
+        workers.push_back(std::thread([&]{
+            for(int i = next++; i < (int) datasets.size(); i = next++)
+            {
+                try
+                {
+                    source.load(i, datasets[i]);
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> guard(failureLock);
+                    if(!failure) failure = std::current_exception();
+                }
+            }
+        }));
+    }
+
+    for(auto it = workers.begin(); it != workers.end(); ++it)
+        it->join();
+
+    if(failure)
+        std::rethrow_exception(failure);
+}
+
+bool BatchExecutor::popOwn(int worker, EvaluationTask& task)
+{
+    std::lock_guard<std::mutex> guard(locks[worker]);
+    if(queues[worker].empty())
+        return false;
+
+    task = queues[worker].front();
+    queues[worker].pop_front();
+    return true;
+}
+
+bool BatchExecutor::steal(int worker, EvaluationTask& task)
+{
+    //queues only shrink once running, so retry until a victim is found or every queue is empty
+    while(true)
+    {
+        int victim = -1;
+        long victimCost = -1;
+
+        for(int w = 0; w < threads; w++)
+        {
+            if(w == worker) continue;
+
+            std::lock_guard<std::mutex> guard(locks[w]);
+            if(!queues[w].empty() && queues[w].front().cost > victimCost)
+            {
+                victim = w;
+                victimCost = queues[w].front().cost;
+            }
+        }
+
+        if(victim == -1)
+            return false;
+
+        std::lock_guard<std::mutex> guard(locks[victim]);
+        if(!queues[victim].empty())
+        {
+            task = queues[victim].front();
+            queues[victim].pop_front();
+            return true;
+        }
+    }
+}
+
+/*
+    run executes <trials> repetitions of <comboLimit> combinations with both objectives on every instance of <datasets>,
+    skipping the tasks <pending> rejects.
+    <runner> runs one task on a handler that already holds the instance, <onResult> is called from the worker as soon as a task finishes.
+*/
+void BatchExecutor::run(std::vector<Dataset>& datasets, int comboLimit, int trials, TaskFilter pending, HandlerFactory makeHandler, TaskRunner runner, ResultCallback onResult)
+{
+    std::vector<EvaluationTask> tasks;
+    for(int i = 0; i < (int) datasets.size(); i++)
+    {
+        for(int c = 0; c < comboLimit; c++)
+        {
+            for(int t = 0; t < trials; t++)
+            {
+                EvaluationTask minTask = {i, (Combination) c, minimization, t, (long) datasets[i].size};
+                EvaluationTask maxTask = {i, (Combination) c, maximization, t, (long) datasets[i].size};
+
+                if(pending(minTask)) tasks.push_back(minTask);
+                if(pending(maxTask)) tasks.push_back(maxTask);
+            }
+        }
+    }
+
+    std::stable_sort(tasks.begin(), tasks.end(), [](const EvaluationTask& a, const EvaluationTask& b){return a.cost > b.cost;});
+
+    for(int i = 0; i < (int) tasks.size(); i++)
+        queues[i % threads].push_back(tasks[i]);
+
+    std::exception_ptr failure;
+    std::mutex failureLock;
+
+    std::vector<std::thread> workers;
+    for(int w = 0; w < threads; w++)
+    {
+        workers.push_back(std::thread([&, w]{
+            AlgorithmHandler *handler = makeHandler();
+            EvaluationTask task;
+
+            try
+            {
+                while(popOwn(w, task) || steal(w, task))
+                {
+                    handler->loadDataset(datasets[task.dataset]);
+                    RunResult result = runner(*handler, task);
+                    onResult(task, result);
+                }
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> guard(failureLock);
+                if(!failure) failure = std::current_exception();
+            }
+
+            delete handler;
+        }));
+    }
+
+    for(auto it = workers.begin(); it != workers.end(); ++it)
+        it->join();
+
+    if(failure)
+        std::rethrow_exception(failure);
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef CANCELLATION_TOKEN_H
+#define CANCELLATION_TOKEN_H
+
+#include <chrono>
+#include <atomic>
+
+/*
+    CancellationToken tells a running generator or optimizer to stop, either because its time budget ran out or because it was cancelled.
+    Algorithms poll expired() in their loops and return the best polygon they have so far.
+*/
+class CancellationToken
+{
+private:
+    std::chrono::steady_clock::time_point deadline;
+    bool hasDeadline;
+    mutable std::atomic<bool> cancelled;
+
+public:
+    CancellationToken(): hasDeadline(false), cancelled(false){};
+
+    void setBudget(std::chrono::milliseconds budget)
+    {
+        deadline = std::chrono::steady_clock::now() + budget;
+        hasDeadline = true;
+    }
+
+    void cancel(){cancelled.store(true, std::memory_order_relaxed);}
+
+    bool expired() const
+    {
+        if(cancelled.load(std::memory_order_relaxed))
+            return true;
+
+        if(hasDeadline && std::chrono::steady_clock::now() >= deadline)
+        {
+            cancelled.store(true, std::memory_order_relaxed);  //sticky, so later polls skip the clock
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "ConvergenceRecorder.h"
+#include "JsonString.h"
+
+#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+
+static std::atomic<bool> recordingCurves(false);
+static FILE* curveOutput = nullptr;
+static std::mutex curveLock;
+static std::chrono::steady_clock::duration curveInterval;
+
+static thread_local std::string curveFile;
+static thread_local std::string curveTag;
+static thread_local int curveTrial = 0;
+
+void openConvergence(std::string path, long intervalMs)
+{
+    curveOutput = fopen(path.c_str(), "w");
+    if(curveOutput == nullptr)
+        throw std::runtime_error("Could not open convergence file " + path);
+
+    curveInterval = std::chrono::milliseconds(intervalMs);
+    recordingCurves = true;
+}
+
+void closeConvergence()
+{
+    if(!recordingCurves)
+        return;
+
+    recordingCurves = false;
+    std::lock_guard<std::mutex> guard(curveLock);
+    fclose(curveOutput);
+    curveOutput = nullptr;
+}
+
+bool convergenceEnabled()
+{
+    return recordingCurves.load(std::memory_order_relaxed);
+}
+
+void setConvergenceContext(const std::string& file, const std::string& tag, int trial)
+{
+    curveFile = file;
+    curveTag = tag;
+    curveTrial = trial;
+}
+
+ConvergenceCurve::ConvergenceCurve(const char* optimizer, OptimizationType type): active(convergenceEnabled()), minimize(type == minimization),
+    optimizer(optimizer), last{0, 0, 0, 0}, lastKept(true)
+{
+    if(!active)
+        return;
+
+    start = std::chrono::steady_clock::now();
+    nextPoint = start;
+}
+
+void ConvergenceCurve::sample(long iteration, double score)
+{
+    double best = score;
+    if(!points.empty())
+        best = minimize ? std::min(score, last.best) : std::max(score, last.best);
+
+    auto now = std::chrono::steady_clock::now();
+    last = {std::chrono::duration<double, std::milli>(now - start).count(), iteration, score, best};
+    lastKept = false;
+
+    if(now >= nextPoint)
+    {
+        points.push_back(last);
+        lastKept = true;
+        nextPoint = now + curveInterval;
+    }
+}
+
+ConvergenceCurve::~ConvergenceCurve()
+{
+    if(!active || points.empty() || !convergenceEnabled())
+        return;
+
+    if(!lastKept)
+        points.push_back(last);
+
+    std::string line = "{\"file\":" + quoteJson(curveFile) + ",\"combination\":" + quoteJson(curveTag) + ",\"trial\":" + std::to_string(curveTrial) +
+        ",\"optimizer\":" + quoteJson(optimizer) + ",\"points\":[";
+    for(auto it = points.begin(); it != points.end(); ++it)
+    {
+        char point[96];
+        snprintf(point, sizeof(point), "%s[%.3f,%ld,%.9g,%.9g]", (it == points.begin()) ? "" : ",", it->elapsed, it->iteration, it->score, it->best);
+        line += point;
+    }
+    line += "]}\n";
+
+    std::lock_guard<std::mutex> guard(curveLock);
+    if(curveOutput != nullptr)
+        fputs(line.c_str(), curveOutput);
+}
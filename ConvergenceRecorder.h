@@ -0,0 +1,66 @@
+#ifndef CONVERGENCE_RECORDER_H
+#define CONVERGENCE_RECORDER_H
+
+#include "shared.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+/*
+    Opt-in anytime curves of the optimizers (-convergence <file>). Each optimizer run keeps a ConvergenceCurve and hands it
+    the score (area / convex hull area) of its current polygon on every iteration of its loop:
+
+        LocalAlgo               a point per improvement, the iteration is the round
+        SimulatedAnnealing      a point per transition, accepted or reverted
+        Ant                     a point per ant, the iteration counts the ants of every cycle
+
+    A point (elapsed ms since the optimizer started, iteration, current score, best score) is kept at most once every
+    -convergenceInterval ms (10 by default, 0 keeps every iteration), the first and the last score of the run are always kept.
+    When the run ends its curve is appended to the file as one JSON line, with the file, combination and trial of the run:
+
+        {"file":"a.instance","combination":"Incremental & Local Search min","trial":0,"optimizer":"local search","points":[[0.012,0,0.71,0.71],...]}
+
+    Cached runs do not run the optimizer and leave no curve. When the file is not opened, record costs a single check.
+*/
+
+void openConvergence(std::string, long);
+void closeConvergence();
+bool convergenceEnabled();
+
+// the file name, combination tag and trial attached to the curves recorded on the calling thread
+void setConvergenceContext(const std::string&, const std::string&, int);
+
+class ConvergenceCurve
+{
+private:
+    struct CurvePoint
+    {
+        double elapsed;     // ms
+        long iteration;
+        double score;
+        double best;
+    };
+
+    bool active;
+    bool minimize;
+    const char* optimizer;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point nextPoint;
+    std::vector<CurvePoint> points;
+    CurvePoint last;        // the latest score handed to the curve
+    bool lastKept;          // whether <last> is already in <points>
+
+    void sample(long, double);
+
+public:
+    ConvergenceCurve(const char* optimizer, OptimizationType type);
+    ~ConvergenceCurve();
+
+    ConvergenceCurve(const ConvergenceCurve&) = delete;
+    ConvergenceCurve& operator=(const ConvergenceCurve&) = delete;
+
+    bool enabled() const {return active;}
+    void record(long iteration, double score){if(active) sample(iteration, score);}
+};
+
+#endif
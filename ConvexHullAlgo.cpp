@@ -1,4 +1,6 @@
 #include "ConvexHullAlgo.h"
+#include "PolygonDump.h"
+#include "RandomSource.h"
 #include <boost/optional/optional_io.hpp>
 #include <random>
 
@@ -29,15 +31,16 @@ Polygon_2 ConvexHullAlgo::generatePolygon(){
     for(auto it = temp.begin(); it != temp.end(); ++it)p.push_back(*it);
 
     //get uniserted points
+    //sort a copy, the list belongs to the handler and the generators that run after this one expect it in its loaded order
     PointList uninserted;
-    std::sort(list.begin(), list.end());
+    PointList sorted = list;
+    std::sort(sorted.begin(), sorted.end());
     std::sort(temp.begin(), temp.end());
-    std::set_difference(list.begin(), list.end(), temp.begin(), temp.end(), std::inserter(uninserted, uninserted.end()));
+    std::set_difference(sorted.begin(), sorted.end(), temp.begin(), temp.end(), std::inserter(uninserted, uninserted.end()));
 
     PointPairList record;
-    std::srand(time(NULL));
     
-    while(!uninserted.empty())
+    while(!uninserted.empty() && !cancelled())
     {
         allClosestReplaceable(p, uninserted, record);
         PointPair selection = selectEdge(record, this->method, p);
@@ -45,6 +48,7 @@ Polygon_2 ConvexHullAlgo::generatePolygon(){
         updateUninserted(selection, uninserted);
     }
     
+    dumpPolygon(p, "convex hull");
 
     return p;
 }
@@ -148,7 +152,7 @@ PointPair selectEdge(PointPairList& record, EdgeSelection method, Polygon_2& pol
     Polygon_2 triangle;
 
     if(method == randomSelection){
-        int choise = std::rand() % record.size();
+        int choise = randomInt() % record.size();
         return *(record.begin() + choise);
     }
     else if(method == EdgeSelection::min){
@@ -314,6 +318,8 @@ OptionalPoint closestReplaceable(Segment_2 segment, Polygon_2& polygon, PointLis
 */
 bool isReplaceable(Point_2 p, Segment_2 initialEdge, Polygon_2& poly)
 {
+    COUNT_OP(replaceableTests);
+    SCOPED_TIMER(timerIsReplaceable);
 
     Point_2 v1 = initialEdge[0];
     Point_2 v2 = initialEdge[1];
@@ -326,6 +332,7 @@ bool isReplaceable(Point_2 p, Segment_2 initialEdge, Polygon_2& poly)
         ++it
     )
     {
+        COUNT_OP(replaceableEdgeTests);
         Segment_2 curr = *it;
         boost::variant<Point_2, Segment_2> var1(curr[0]);
         boost::variant<Point_2, Segment_2> var2(curr[1]);
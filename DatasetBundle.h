@@ -0,0 +1,266 @@
+#ifndef DATASET_BUNDLE_H
+#define DATASET_BUNDLE_H
+
+#include "shared.h"
+#include "PointLoader.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+#include <filesystem>
+#include <functional>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+    A bundle packs a whole directory of point files into one file:
+
+        BundleHeader
+        BundleIndexEntry[instanceCount]    one entry per instance
+        names                              the original file paths, not null terminated
+        coordinates                        packed int32 x,y pairs of every instance, 8 byte aligned
+
+    The file is memory mapped once and every instance is exposed as a BundleInstance view into the mapping.
+*/
+
+static const char bundleMagic[8] = {'P', 'T', 'B', 'U', 'N', 'D', 'L', 'E'};
+static const uint32_t bundleVersion = 1;
+
+struct BundleHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t instanceCount;
+    uint64_t namesOffset;
+    uint64_t coordinatesOffset;
+};
+
+struct BundleIndexEntry
+{
+    uint64_t offset;        // byte offset of the first coordinate of the instance
+    uint64_t nameOffset;    // byte offset of the name of the instance
+    uint32_t nameLength;
+    uint32_t pointCount;
+    int64_t convexHullArea;
+};
+
+// non owning view of one instance of a mapped bundle
+struct BundleInstance
+{
+    std::string name;
+    const int32_t* coordinates; // pointCount x,y pairs
+    int pointCount;
+    long convexHullArea;
+};
+
+// returns true if <path> is a regular file that starts with the bundle magic
+bool isBundleFile(std::string path)
+{
+    if(!std::filesystem::is_regular_file(path))
+        return false;
+
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(bundleMagic)];
+    if(!in.read(magic, sizeof(magic)))
+        return false;
+
+    return !memcmp(magic, bundleMagic, sizeof(bundleMagic));
+}
+
+class DatasetBundle
+{
+private:
+    const char* data;
+    size_t length;
+    const BundleHeader* header;
+    const BundleIndexEntry* index;
+
+public:
+    DatasetBundle(std::string path);
+    ~DatasetBundle();
+
+    DatasetBundle(const DatasetBundle&) = delete;
+    DatasetBundle& operator=(const DatasetBundle&) = delete;
+
+    int count(){return header->instanceCount;}
+    BundleInstance instance(int);
+};
+
+DatasetBundle::DatasetBundle(std::string path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        throw std::runtime_error("Could not open bundle " + path);
+
+    struct stat info;
+    if(fstat(fd, &info) < 0 || (size_t) info.st_size < sizeof(BundleHeader))
+    {
+        close(fd);
+        throw std::runtime_error("Could not read bundle " + path);
+    }
+
+    length = info.st_size;
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(mapped == MAP_FAILED)
+        throw std::runtime_error("Could not map bundle " + path);
+
+    data = (const char*) mapped;
+    header = (const BundleHeader*) data;
+    index = (const BundleIndexEntry*) (data + sizeof(BundleHeader));
+
+    //validate the header and every index entry once, so instance() can trust them
+    bool valid = !memcmp(header->magic, bundleMagic, sizeof(bundleMagic)) && header->version == bundleVersion
+        && sizeof(BundleHeader) + (uint64_t) header->instanceCount * sizeof(BundleIndexEntry) <= header->namesOffset
+        && header->namesOffset <= header->coordinatesOffset && header->coordinatesOffset <= length;
+
+    for(uint32_t i = 0; valid && i < header->instanceCount; i++)
+    {
+        const BundleIndexEntry& entry = index[i];
+        valid = entry.nameOffset >= header->namesOffset && entry.nameOffset + entry.nameLength <= header->coordinatesOffset
+            && entry.offset >= header->coordinatesOffset && entry.offset % sizeof(int32_t) == 0
+            && entry.offset + (uint64_t) entry.pointCount * 2 * sizeof(int32_t) <= length;
+    }
+
+    if(!valid)
+    {
+        munmap(mapped, length);
+        throw std::runtime_error("Corrupted bundle " + path);
+    }
+
+    madvise(mapped, length, MADV_WILLNEED);
+}
+
+DatasetBundle::~DatasetBundle()
+{
+    munmap((void*) data, length);
+}
+
+BundleInstance DatasetBundle::instance(int i)
+{
+    const BundleIndexEntry& entry = index[i];
+
+    BundleInstance result;
+    result.name = std::string(data + entry.nameOffset, entry.nameLength);
+    result.coordinates = (const int32_t*) (data + entry.offset);
+    result.pointCount = entry.pointCount;
+    result.convexHullArea = entry.convexHullArea;
+    return result;
+}
+
+// copies the points of <instance> into <points>, the same way getPointsFromFile does for a text file
+void getPointsFromBundle(const BundleInstance& instance, int& size, PointList& points, long& convexHullArea)
+{
+    points.reserve(points.size() + instance.pointCount);
+
+    const int32_t* coordinate = instance.coordinates;
+    for(int i = 0; i < instance.pointCount; i++, coordinate += 2)
+        points.push_back(Point_2(coordinate[0], coordinate[1]));
+
+    size = points.size();
+    convexHullArea = instance.convexHullArea;
+}
+
+// a coordinate of the instance <name> as stored in a bundle, which only holds 32-bit integers
+inline int32_t bundleCoordinate(double value, const std::string& name)
+{
+    if(!(value >= INT32_MIN && value <= INT32_MAX))
+    {
+        char text[64];
+        snprintf(text, sizeof(text), "%.0f", value);
+        throw std::runtime_error("Coordinate " + std::string(text) + " of " + name + " does not fit in a bundle (32-bit integers)");
+    }
+    return (int32_t) value;
+}
+
+// fills the packed x,y coordinates and the convex hull area of the instance at the given position
+typedef std::function<void(size_t, std::vector<int32_t>&, long&)> BundleSource;
+
+/*
+    writeBundle writes a bundle at <bundlePath> holding one instance per name of <names>, in that order.
+    The points of every instance come from <source>, one instance at a time.
+*/
+void writeBundle(std::string bundlePath, const std::vector<std::string>& names, BundleSource source)
+{
+    BundleHeader header;
+    memcpy(header.magic, bundleMagic, sizeof(bundleMagic));
+    header.version = bundleVersion;
+    header.instanceCount = names.size();
+    header.namesOffset = sizeof(BundleHeader) + names.size() * sizeof(BundleIndexEntry);
+
+    std::vector<BundleIndexEntry> index(names.size());
+    uint64_t offset = header.namesOffset;
+    for(size_t i = 0; i < names.size(); i++)
+    {
+        index[i].nameOffset = offset;
+        index[i].nameLength = names[i].size();
+        offset += names[i].size();
+    }
+    header.coordinatesOffset = (offset + 7) & ~(uint64_t) 7;
+
+    std::ofstream out(bundlePath, std::ios::binary | std::ios::trunc);
+    if(!out)
+        throw std::runtime_error("Could not create bundle " + bundlePath);
+
+    //the index is only known after every file is parsed, so leave room for it and write it last
+    out.seekp(header.coordinatesOffset);
+
+    std::vector<int32_t> coordinates;
+    offset = header.coordinatesOffset;
+
+    for(size_t i = 0; i < names.size(); i++)
+    {
+        long convexHullArea;
+        coordinates.clear();
+        source(i, coordinates, convexHullArea);
+        out.write((const char*) coordinates.data(), coordinates.size() * sizeof(int32_t));
+
+        index[i].offset = offset;
+        index[i].pointCount = coordinates.size() / 2;
+        index[i].convexHullArea = convexHullArea;
+        offset += coordinates.size() * sizeof(int32_t);
+    }
+
+    out.seekp(0);
+    out.write((const char*) &header, sizeof(header));
+    out.write((const char*) index.data(), index.size() * sizeof(BundleIndexEntry));
+    for(auto it = names.begin(); it != names.end(); ++it)
+        out.write(it->data(), it->size());
+
+    if(!out)
+        throw std::runtime_error("Could not write bundle " + bundlePath);
+}
+
+/*
+    packDirectory converts every point file of <directory> to a single bundle at <bundlePath>.
+    Files are visited in directory_iterator order, the same order evaluate uses for -i <directory>.
+*/
+void packDirectory(std::string directory, std::string bundlePath)
+{
+    std::vector<std::string> names;
+    for(const auto & entry : std::filesystem::directory_iterator(directory))
+        names.push_back(entry.path());
+
+    PointList points;
+    writeBundle(bundlePath, names, [&](size_t i, std::vector<int32_t>& coordinates, long& convexHullArea){
+        int size;
+        points.clear();
+        getPointsFromFile(names[i], size, points, convexHullArea);
+
+        for(auto it = points.begin(); it != points.end(); ++it)
+        {
+            coordinates.push_back(bundleCoordinate(it->x(), names[i]));
+            coordinates.push_back(bundleCoordinate(it->y(), names[i]));
+        }
+    });
+}
+
+#endif
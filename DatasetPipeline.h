@@ -0,0 +1,237 @@
+#ifndef DATASET_PIPELINE_H
+#define DATASET_PIPELINE_H
+
+#include "shared.h"
+#include "PointLoader.h"
+#include "DatasetBundle.h"
+#include "Trace.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <cstdint>
+#include <functional>
+
+/*
+    shardOf assigns an instance to one of <shards> shards by hashing (FNV-1a) the file name of its path.
+    Only the file name is hashed, so a directory and a bundle of it, or copies of it at different locations, are split the same way.
+*/
+int shardOf(std::string path, int shards)
+{
+    std::string name = std::filesystem::path(path).filename().string();
+
+    uint64_t hash = 14695981039346656037ULL;
+    for(auto it = name.begin(); it != name.end(); ++it)
+    {
+        hash ^= (unsigned char) *it;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash % shards;
+}
+
+/*
+    DatasetSource gives uniform, indexed access to the instances of an input, which is either a directory of point files or a bundle.
+*/
+class DatasetSource
+{
+private:
+    std::vector<std::string> files;
+    DatasetBundle *bundle;
+    std::vector<int> order;    // position in the input of every instance the source exposes
+
+    std::string inputName(int);
+
+public:
+    DatasetSource(std::string input);
+    ~DatasetSource(){delete bundle;}
+
+    DatasetSource(const DatasetSource&) = delete;
+    DatasetSource& operator=(const DatasetSource&) = delete;
+
+    int count(){return order.size();}
+    std::string name(int);
+    void load(int, Dataset&);
+
+    void retain(std::function<bool(const std::string&)>);
+    void restrictToShard(int, int);
+};
+
+DatasetSource::DatasetSource(std::string input): bundle(nullptr)
+{
+    if(isBundleFile(input))
+        bundle = new DatasetBundle(input);
+    else
+        for(const auto & entry : std::filesystem::directory_iterator(input))
+            files.push_back(entry.path());
+
+    int total = (bundle != nullptr) ? bundle->count() : files.size();
+    for(int i = 0; i < total; i++)
+        order.push_back(i);
+}
+
+std::string DatasetSource::inputName(int position)
+{
+    return (bundle != nullptr) ? bundle->instance(position).name : files[position];
+}
+
+std::string DatasetSource::name(int i)
+{
+    return inputName(order[i]);
+}
+
+// loads instance <i> into <dataset>, reusing the capacity of its point list
+void DatasetSource::load(int i, Dataset& dataset)
+{
+    TraceSpan span("load", "file load", traceEnabled() ? traceArgument("file", name(i)) : "");
+
+    dataset.id = i;
+    dataset.points.clear();
+
+    if(bundle != nullptr)
+    {
+        BundleInstance instance = bundle->instance(order[i]);
+        dataset.name = instance.name;
+        getPointsFromBundle(instance, dataset.size, dataset.points, dataset.convexHullArea);
+    }
+    else
+    {
+        dataset.name = files[order[i]];
+        getPointsFromFile(dataset.name, dataset.size, dataset.points, dataset.convexHullArea);
+    }
+
+    dataset.fingerprint = fingerprintPoints(dataset.points);
+}
+
+// keeps only the instances whose name satisfies <keep>, in their current order
+void DatasetSource::retain(std::function<bool(const std::string&)> keep)
+{
+    std::vector<int> kept;
+    for(auto it = order.begin(); it != order.end(); ++it)
+        if(keep(inputName(*it)))
+            kept.push_back(*it);
+
+    order.swap(kept);
+}
+
+// keeps only the instances that belong to shard <shard> of <shards>
+void DatasetSource::restrictToShard(int shard, int shards)
+{
+    retain([&](const std::string& name){return shardOf(name, shards) == shard;});
+}
+
+/*
+    DatasetPipeline parses the instances of a DatasetSource on a background thread into a bounded ring of ready datasets,
+    so the parsing of the next files overlaps with the algorithms running on the current one.
+*/
+class DatasetPipeline
+{
+private:
+    DatasetSource& source;
+    std::vector<Dataset> ring;
+    int head;       // next slot the consumer takes
+    int ready;      // number of parsed slots waiting for the consumer
+    int produced;   // number of instances parsed so far
+    bool stopping;
+    std::exception_ptr failure;
+
+    std::mutex lock;
+    std::condition_variable slotReady;
+    std::condition_variable slotFree;
+    std::thread producer;
+
+    void produce();
+
+public:
+    DatasetPipeline(DatasetSource&, int);
+    ~DatasetPipeline();
+
+    bool next(Dataset&);
+};
+
+DatasetPipeline::DatasetPipeline(DatasetSource& source, int depth): source(source), ring(std::max(depth, 1)), head(0), ready(0), produced(0), stopping(false)
+{
+    producer = std::thread(&DatasetPipeline::produce, this);
+}
+
+DatasetPipeline::~DatasetPipeline()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    slotFree.notify_all();
+    producer.join();
+}
+
+void DatasetPipeline::produce()
+{
+    int total = source.count();
+    int capacity = ring.size();
+
+    for(int i = 0; i < total; i++)
+    {
+        int slot;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            slotFree.wait(guard, [&]{return stopping || ready < capacity;});
+            if(stopping) return;
+            slot = (head + ready) % capacity;
+        }
+
+        //the slot is owned by the producer until it is published, so parse it outside the lock
+        try
+        {
+            source.load(i, ring[slot]);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            failure = std::current_exception();
+            produced = total;
+            slotReady.notify_one();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            ready++;
+            produced++;
+        }
+        slotReady.notify_one();
+    }
+}
+
+/*
+    next swaps the next parsed dataset into <dataset> and returns false once every instance has been consumed.
+    The swap hands the old point list of <dataset> back to the ring, so its capacity gets reused.
+    A parsing failure on the background thread is rethrown here, in input order.
+*/
+bool DatasetPipeline::next(Dataset& dataset)
+{
+    int total = source.count();
+
+    std::unique_lock<std::mutex> guard(lock);
+    slotReady.wait(guard, [&]{return ready > 0 || produced == total;});
+
+    if(ready == 0)
+    {
+        if(failure)
+            std::rethrow_exception(failure);
+        return false;
+    }
+
+    std::swap(dataset, ring[head]);
+    head = (head + 1) % ring.size();
+    ready--;
+
+    guard.unlock();
+    slotFree.notify_one();
+    return true;
+}
+
+#endif
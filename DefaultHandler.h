@@ -15,15 +15,19 @@ class DefaultHandler : public AlgorithmHandler{
 private:
     
 public:
+    DefaultHandler(): AlgorithmHandler(){};
     DefaultHandler(std::string filename): AlgorithmHandler(filename){};
 
+    //bump the version whenever a parameter below changes, so cached results of the old parameters are not reused
+    virtual std::string parameterSignature(){return "default-1";}
+
     virtual double incrementalLocalSearch(OptimizationType type)
     {
         IncAlgo *generator = new IncAlgo(points, Initialization::a1, EdgeSelection::randomSelection);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         LocalAlgo *optimizer = new LocalAlgo(initial, convexHullArea, 0.10, type, 1);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -31,10 +35,10 @@ public:
     virtual double incrementalAnnealing(OptimizationType type)
     {
         IncAlgo *generator = new IncAlgo(points, Initialization::a1, EdgeSelection::randomSelection);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         SimulatedAnnealing *optimizer = new SimulatedAnnealing(initial, convexHullArea, 2500, type, AnnealingType::local);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -42,10 +46,10 @@ public:
     virtual double convexHullLocalSearch(OptimizationType type)
     {
         ConvexHullAlgo *generator = new ConvexHullAlgo(points, EdgeSelection::randomSelection);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         LocalAlgo *optimizer = new LocalAlgo(initial, convexHullArea, 0.10, type, 1);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -53,10 +57,10 @@ public:
     virtual double convexHullAnnealing(OptimizationType type)
     {
         ConvexHullAlgo *generator = new ConvexHullAlgo(points, EdgeSelection::randomSelection);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         SimulatedAnnealing *optimizer = new SimulatedAnnealing(initial, convexHullArea, 2500, type, AnnealingType::local);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -64,10 +68,10 @@ public:
     virtual double onionLocalSearch(OptimizationType type)
     {
         OnionAlgo *generator = new OnionAlgo(points, 3);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         LocalAlgo *optimizer = new LocalAlgo(initial, convexHullArea, 0.7, type, 5);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -75,10 +79,10 @@ public:
     virtual double onionAnnealing(OptimizationType type)
     {
         OnionAlgo *generator = new OnionAlgo(points, 1);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         SimulatedAnnealing *optimizer = new SimulatedAnnealing(initial, convexHullArea, 2500, type, AnnealingType::local);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -98,7 +102,7 @@ public:
 
         
         Ant *optimizer = new Ant(dummy, points, dummyPoly);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -0,0 +1,35 @@
+#ifndef JSON_STRING_H
+#define JSON_STRING_H
+
+#include <string>
+#include <cstdio>
+
+/*
+    A string as a quoted JSON value, for the files written a line or an event at a time (-results, -trace, -convergence).
+    Quotes and backslashes are escaped and control characters become \u00XX, anything else is copied as is.
+*/
+
+inline std::string quoteJson(const std::string& text)
+{
+    std::string quoted = "\"";
+    for(auto it = text.begin(); it != text.end(); ++it)
+    {
+        unsigned char c = *it;
+        if(c == '"' || c == '\\')
+        {
+            quoted += '\\';
+            quoted += (char) c;
+        }
+        else if(c < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            quoted += escaped;
+        }
+        else
+            quoted += (char) c;
+    }
+    return quoted + "\"";
+}
+
+#endif
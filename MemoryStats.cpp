@@ -0,0 +1,72 @@
+#include "MemoryStats.h"
+
+#include <new>
+#include <cstdlib>
+#include <malloc.h>
+
+/*
+    Replacement global allocation operators that count the allocations of every thread into threadAllocations (MemoryStats.h).
+    allocatedBytes adds up the sizes the callers asked for. The live and peak bytes use malloc_usable_size instead, the size
+    a free can find again, so a block leaves the live bytes with the same size it entered them.
+*/
+
+#ifndef EVALUATE_NO_ALLOC_COUNTERS
+
+static inline void* countAllocation(void* memory, std::size_t requested)
+{
+    if(memory != nullptr)
+    {
+        long long bytes = malloc_usable_size(memory);
+        AllocationCounts& counts = threadAllocations;
+        counts.allocations++;
+        counts.allocatedBytes += requested;
+        counts.liveBytes += bytes;
+        if(counts.liveBytes > counts.peakBytes)
+            counts.peakBytes = counts.liveBytes;
+    }
+    return memory;
+}
+
+static inline void countFree(void* memory)
+{
+    if(memory != nullptr)
+        threadAllocations.liveBytes -= malloc_usable_size(memory);
+    free(memory);
+}
+
+static void* allocate(std::size_t size)
+{
+    void* memory = countAllocation(malloc(size ? size : 1), size);
+    if(memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+static void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    std::size_t align = (std::size_t) alignment;
+    void* memory = countAllocation(aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align), size);
+    if(memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new(std::size_t size){return allocate(size);}
+void* operator new[](std::size_t size){return allocate(size);}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept{return countAllocation(malloc(size ? size : 1), size);}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept{return countAllocation(malloc(size ? size : 1), size);}
+void* operator new(std::size_t size, std::align_val_t alignment){return allocateAligned(size, alignment);}
+void* operator new[](std::size_t size, std::align_val_t alignment){return allocateAligned(size, alignment);}
+
+void operator delete(void* memory) noexcept{countFree(memory);}
+void operator delete[](void* memory) noexcept{countFree(memory);}
+void operator delete(void* memory, std::size_t) noexcept{countFree(memory);}
+void operator delete[](void* memory, std::size_t) noexcept{countFree(memory);}
+void operator delete(void* memory, const std::nothrow_t&) noexcept{countFree(memory);}
+void operator delete[](void* memory, const std::nothrow_t&) noexcept{countFree(memory);}
+void operator delete(void* memory, std::align_val_t) noexcept{countFree(memory);}
+void operator delete[](void* memory, std::align_val_t) noexcept{countFree(memory);}
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept{countFree(memory);}
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept{countFree(memory);}
+
+#endif
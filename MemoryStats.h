@@ -0,0 +1,106 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <sys/resource.h>
+
+/*
+    Memory accounting of a run, written to the results file (-results) next to its score:
+
+        peak RSS delta      growth of the peak resident set size of the process while the run executed, in KB.
+                            The peak is process wide, so with -threads it also grows with the runs of the other threads.
+        allocations         operator new calls of the thread and the bytes they asked for, counted by the replacement
+                            operators of MemoryStats.cpp
+        heap peak           the most bytes the thread held allocated at once during the run, over what it held when the run started,
+                            as the allocator sized the blocks (malloc_usable_size), so rounding up included
+        container marks     the largest size the containers that grow with the input reached, recorded with MARK_HIGH
+
+    Every thread counts into its own thread_local block, like OpCounters.h, and a run keeps the difference of the counts of its thread.
+    Building with -DEVALUATE_NO_ALLOC_COUNTERS leaves operator new alone and removes every MARK_HIGH, only the RSS is then measured.
+*/
+
+enum MemoryMark
+{
+    antPolygons,        // child polygons Ant keeps in polymap, over all its expanded nodes
+    antLevelPolygons,   // polygons Ant keeps in map, over all its levels
+    antGraphNodes,      // nodes of the pheromone graph of Ant (table1)
+    antPathEntries,     // ant positions Ant keeps in tables
+    localChanges,       // candidate changes LocalAlgo keeps in possibleChanges
+    memoryMarkCount
+};
+
+// column names of the marks in the results file
+inline const char* memoryMarkName(int mark)
+{
+    static const char* names[memoryMarkCount] = {"ant_polygons", "ant_level_polygons", "ant_graph_nodes", "ant_path_entries", "local_changes"};
+    return names[mark];
+}
+
+struct AllocationCounts
+{
+    unsigned long long allocations;
+    unsigned long long allocatedBytes;
+    long long liveBytes;    // bytes allocated and not yet freed by the thread, frees of memory allocated on other threads included
+    long long peakBytes;    // the highest liveBytes since the last run started
+};
+
+// the memory used by one run, none for cached results
+struct MemoryUsage
+{
+    long peakRssDelta = 0;      // KB
+    unsigned long long allocations = 0;
+    unsigned long long allocatedBytes = 0;
+    long long heapPeakBytes = 0;
+    unsigned long long marks[memoryMarkCount] = {};
+};
+
+// the counts and the marks of the calling thread, plain data so the allocation operators can use them at any time
+inline thread_local AllocationCounts threadAllocations;
+inline thread_local unsigned long long threadMemoryMarks[memoryMarkCount];
+
+#ifdef EVALUATE_NO_ALLOC_COUNTERS
+    #define MARK_HIGH(mark, size) ((void) 0)
+#else
+    #define MARK_HIGH(mark, size) \
+        do{ unsigned long long markSize = (size); if(markSize > threadMemoryMarks[mark]) threadMemoryMarks[mark] = markSize; }while(0)
+#endif
+
+// KB of the peak resident set size of the process so far
+inline long peakRss()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// what a run needs to remember of the state of its thread when it starts
+struct MemorySnapshot
+{
+    AllocationCounts counts;
+    long peakRss;
+};
+
+// starts the accounting of a run on the calling thread
+inline MemorySnapshot startMemoryRun()
+{
+    threadAllocations.peakBytes = threadAllocations.liveBytes;
+    for(int i = 0; i < memoryMarkCount; i++)
+        threadMemoryMarks[i] = 0;
+
+    return {threadAllocations, peakRss()};
+}
+
+// the memory used on the calling thread since <start>
+inline MemoryUsage finishMemoryRun(const MemorySnapshot& start)
+{
+    MemoryUsage usage;
+    usage.peakRssDelta = peakRss() - start.peakRss;
+    usage.allocations = threadAllocations.allocations - start.counts.allocations;
+    usage.allocatedBytes = threadAllocations.allocatedBytes - start.counts.allocatedBytes;
+    usage.heapPeakBytes = threadAllocations.peakBytes - start.counts.liveBytes;
+    for(int i = 0; i < memoryMarkCount; i++)
+        usage.marks[i] = threadMemoryMarks[i];
+
+    return usage;
+}
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef METRICS_REPORTER_H
+#define METRICS_REPORTER_H
+
+#include "shared.h"
+#include "ResultLogger.h"
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+/*
+    Live progress of an evaluation (-metrics <file>) in the Prometheus text exposition format, for the textfile collector
+    of a node exporter. A background thread rewrites the file every -metricsInterval seconds (5 by default) and once more
+    when the evaluation ends, always through a temporary file and a rename, so a scrape never reads half a file:
+
+        evaluate_files, evaluate_files_done                 input files and files whose runs have all finished
+        evaluate_tasks, evaluate_tasks_done                 runs of the evaluation and runs finished or found in the journal
+        evaluate_tasks_in_flight                            runs executing right now
+        evaluate_elapsed_seconds, evaluate_eta_seconds      the remaining runs are expected to take as long as the ones executed so far,
+                                                            cached runs are left out of the average
+        evaluate_runs_total{combination,objective}          finished runs, cached ones included
+        evaluate_points_total, evaluate_run_seconds_total   points and wall time of the runs that executed
+        evaluate_points_per_second                          their ratio
+        evaluate_cutoffs_total                              runs stopped by the time budget
+
+    The evaluation only updates a few counters under a lock when a run starts and ends, it never waits for the file.
+*/
+
+struct CombinationMetrics
+{
+    long runs = 0;
+    long points = 0;
+    double seconds = 0;
+    long cutoffs = 0;
+};
+
+class MetricsReporter
+{
+private:
+    std::string path;
+    std::chrono::seconds interval;
+    std::chrono::steady_clock::time_point start;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    bool stopping;
+    std::thread writer;
+
+    long files;
+    long filesDone;
+    long tasks;
+    long tasksDone;
+    long tasksSkipped;  // runs found in the journal, they cost nothing
+    long tasksExecuted; // finished runs that were not found in the cache
+    long inFlight;
+    CombinationMetrics combinations[antColony + 1][2];
+
+    bool writeFile();
+    void loop();
+
+public:
+    MetricsReporter(std::string path, long intervalSeconds);
+    ~MetricsReporter();
+
+    MetricsReporter(const MetricsReporter&) = delete;
+    MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+    // the files of the evaluation and the runs each of them needs
+    void setWork(long, long);
+
+    void startRun();
+    void finishRun(Combination, OptimizationType, int, const RunResult&);
+    void skipRun();
+    void finishFile();
+
+    // stops the writer after a last update of the file
+    void stop();
+};
+
+MetricsReporter::MetricsReporter(std::string path, long intervalSeconds): path(path), interval(intervalSeconds), stopping(false),
+    files(0), filesDone(0), tasks(0), tasksDone(0), tasksSkipped(0), tasksExecuted(0), inFlight(0)
+{
+    start = std::chrono::steady_clock::now();
+
+    //fail now rather than on the first update, a later failed update only leaves the previous file in place
+    if(!writeFile())
+        throw std::runtime_error("Could not write metrics file " + path);
+    writer = std::thread(&MetricsReporter::loop, this);
+}
+
+MetricsReporter::~MetricsReporter()
+{
+    stop();
+}
+
+void MetricsReporter::setWork(long fileCount, long runsPerFile)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    files = fileCount;
+    tasks = fileCount * runsPerFile;
+}
+
+void MetricsReporter::startRun()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    inFlight++;
+}
+
+void MetricsReporter::finishRun(Combination combo, OptimizationType type, int size, const RunResult& result)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    inFlight--;
+    tasksDone++;
+
+    CombinationMetrics& metrics = combinations[combo][type == minimization ? 0 : 1];
+    metrics.runs++;
+    if(result.cutoff)
+        metrics.cutoffs++;
+    if(!result.cached)
+    {
+        tasksExecuted++;
+        metrics.points += size;
+        metrics.seconds += result.duration / 1000.0;
+    }
+}
+
+void MetricsReporter::skipRun()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    tasksSkipped++;
+}
+
+void MetricsReporter::finishFile()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    filesDone++;
+}
+
+void MetricsReporter::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if(stopping)
+            return;
+        stopping = true;
+    }
+    wake.notify_all();
+    writer.join();
+    writeFile();
+}
+
+void MetricsReporter::loop()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while(!stopping)
+    {
+        wake.wait_for(guard, interval);
+        if(stopping)
+            break;
+
+        guard.unlock();
+        writeFile();
+        guard.lock();
+    }
+}
+
+// prints a metric of every combination and objective that had a run
+static void writeCombinationMetric(FILE* output, const char* name, const char* type, const char* help, const CombinationMetrics (&combinations)[antColony + 1][2],
+    double (*value)(const CombinationMetrics&))
+{
+    fprintf(output, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    for(int combo = 0; combo <= antColony; combo++)
+    {
+        for(int objective = 0; objective < 2; objective++)
+        {
+            if(combinations[combo][objective].runs == 0)
+                continue;
+
+            fprintf(output, "%s{combination=\"%s\",objective=\"%s\"} %.12g\n", name, combinationShortName((Combination) combo).c_str(),
+                objective == 0 ? "min" : "max", value(combinations[combo][objective]));
+        }
+    }
+}
+
+// writes the file under a temporary name and renames it over the previous one
+bool MetricsReporter::writeFile()
+{
+    long fileCount, filesFinished, taskCount, tasksFinished, skipped, executed, running;
+    CombinationMetrics snapshot[antColony + 1][2];
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        fileCount = files;
+        filesFinished = filesDone;
+        taskCount = tasks;
+        tasksFinished = tasksDone;
+        skipped = tasksSkipped;
+        executed = tasksExecuted;
+        running = inFlight;
+        for(int combo = 0; combo <= antColony; combo++)
+            for(int objective = 0; objective < 2; objective++)
+                snapshot[combo][objective] = combinations[combo][objective];
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long remaining = std::max(taskCount - tasksFinished - skipped, 0L);
+    //cache hits finish almost at once, counting them would make the remaining runs look far cheaper than they are
+    double eta = (executed > 0) ? elapsed * remaining / executed : (remaining == 0 ? 0 : NAN);
+
+    std::string temporary = path + ".tmp";
+    FILE* output = fopen(temporary.c_str(), "w");
+    if(output == nullptr)
+        return false;
+
+    fprintf(output, "# HELP evaluate_files Input files of the evaluation.\n# TYPE evaluate_files gauge\nevaluate_files %ld\n", fileCount);
+    fprintf(output, "# HELP evaluate_files_done Files whose runs have all finished.\n# TYPE evaluate_files_done gauge\nevaluate_files_done %ld\n", filesFinished);
+    fprintf(output, "# HELP evaluate_tasks Runs of the evaluation.\n# TYPE evaluate_tasks gauge\nevaluate_tasks %ld\n", taskCount);
+    fprintf(output, "# HELP evaluate_tasks_done Runs finished or found in the journal.\n# TYPE evaluate_tasks_done gauge\nevaluate_tasks_done %ld\n", tasksFinished + skipped);
+    fprintf(output, "# HELP evaluate_tasks_in_flight Runs executing now.\n# TYPE evaluate_tasks_in_flight gauge\nevaluate_tasks_in_flight %ld\n", running);
+    fprintf(output, "# HELP evaluate_elapsed_seconds Time since the evaluation started.\n# TYPE evaluate_elapsed_seconds gauge\nevaluate_elapsed_seconds %.3f\n", elapsed);
+    fprintf(output, "# HELP evaluate_eta_seconds Expected time until every run has finished.\n# TYPE evaluate_eta_seconds gauge\n");
+    if(std::isnan(eta))
+        fprintf(output, "evaluate_eta_seconds NaN\n");
+    else
+        fprintf(output, "evaluate_eta_seconds %.3f\n", eta);
+
+    writeCombinationMetric(output, "evaluate_runs_total", "counter", "Finished runs.", snapshot,
+        [](const CombinationMetrics& metrics){return (double) metrics.runs;});
+    writeCombinationMetric(output, "evaluate_points_total", "counter", "Points of the runs that executed.", snapshot,
+        [](const CombinationMetrics& metrics){return (double) metrics.points;});
+    writeCombinationMetric(output, "evaluate_run_seconds_total", "counter", "Wall time of the runs that executed.", snapshot,
+        [](const CombinationMetrics& metrics){return metrics.seconds;});
+    writeCombinationMetric(output, "evaluate_points_per_second", "gauge", "Points processed per second of run time.", snapshot,
+        [](const CombinationMetrics& metrics){return (metrics.seconds > 0) ? metrics.points / metrics.seconds : 0.0;});
+    writeCombinationMetric(output, "evaluate_cutoffs_total", "counter", "Runs stopped by the time budget.", snapshot,
+        [](const CombinationMetrics& metrics){return (double) metrics.cutoffs;});
+
+    bool written = !ferror(output);
+    written = (fclose(output) == 0) && written;
+    return written && rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+#endif
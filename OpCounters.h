@@ -0,0 +1,61 @@
+#ifndef OP_COUNTERS_H
+#define OP_COUNTERS_H
+
+/*
+    Counters of the operations that dominate the running time of the algorithms, reported per file and combination with -stats.
+    Every thread counts into its own thread_local block, so counting costs one increment and never synchronizes.
+    A run reads the counts of its thread before and after it executes and keeps the difference.
+    Building with -DEVALUATE_NO_OP_COUNTERS removes every COUNT_OP from the code.
+*/
+
+enum OpCounter
+{
+    localSimpleChecks,      // is_simple() tests of candidate polygons in LocalAlgo
+    replaceableTests,       // isReplaceable() calls of ConvexHullAlgo and IncAlgo
+    replaceableEdgeTests,   // edges of the polygon tested for intersection by isReplaceable()
+    annealingKdQueries,     // Kd-tree range queries of validityLocal()
+    annealingRejected,      // transitions that failed the validity check and were drawn again
+    annealingAccepted,      // valid transitions that were kept
+    annealingReverted,      // valid transitions undone by the Metropolis criterion
+    opCounterCount
+};
+
+inline const char* opCounterName(int counter)
+{
+    static const char* names[opCounterCount] = {"local is_simple", "replaceable tests", "replaceable edges", "ann kd queries",
+        "ann rejected", "ann accepted", "ann reverted"};
+    return names[counter];
+}
+
+struct OpCounts
+{
+    unsigned long long values[opCounterCount] = {};
+
+    OpCounts& operator+=(const OpCounts& other)
+    {
+        for(int i = 0; i < opCounterCount; i++) values[i] += other.values[i];
+        return *this;
+    }
+
+    OpCounts operator-(const OpCounts& other) const
+    {
+        OpCounts difference;
+        for(int i = 0; i < opCounterCount; i++) difference.values[i] = values[i] - other.values[i];
+        return difference;
+    }
+};
+
+// the counts of the calling thread
+inline thread_local OpCounts threadOpCounts;
+
+#ifdef EVALUATE_NO_OP_COUNTERS
+    #define COUNT_OP(counter) ((void) 0)
+    #define COUNT_OPS(counter, amount) ((void) 0)
+    static const bool opCountersEnabled = false;
+#else
+    #define COUNT_OP(counter) (++threadOpCounts.values[counter])
+    #define COUNT_OPS(counter, amount) (threadOpCounts.values[counter] += (amount))
+    static const bool opCountersEnabled = true;
+#endif
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <string>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/*
+    Hardware counters of a run (-perfcounters): cycles, instructions, cache misses and branch misses of the calling thread,
+    counted by one Linux perf_event_open group per thread so the counters of a run are scheduled together.
+    If the group can not be opened (another OS, a container or perf_event_paranoid forbidding it) the group is unavailable
+    and runs carry no counts. An event the CPU does not support is left out of the group and only that counter is missing.
+    When the kernel multiplexes the group, the counts are scaled by the share of the run it was counting.
+*/
+
+enum PerfCounter
+{
+    perfCycles,
+    perfInstructions,
+    perfCacheMisses,
+    perfBranchMisses,
+    perfCounterCount
+};
+
+inline const char* perfCounterName(int counter)
+{
+    static const char* names[perfCounterCount] = {"cycles", "instructions", "cache misses", "branch misses"};
+    return names[counter];
+}
+
+// the counts of one run, only the <measured> counters hold values
+struct PerfCounts
+{
+    bool measured[perfCounterCount] = {};
+    unsigned long long values[perfCounterCount] = {};
+
+    bool any() const
+    {
+        for(int i = 0; i < perfCounterCount; i++)
+            if(measured[i]) return true;
+        return false;
+    }
+};
+
+class PerfCounterGroup
+{
+private:
+    int descriptors[perfCounterCount];
+    unsigned long long ids[perfCounterCount];   // kernel ids of the counters, which tell them apart in a group read
+    int leader;             // descriptor of the first counter that opened, -1 if none did
+    std::string failure;    // why the group is unavailable
+
+public:
+    PerfCounterGroup(): leader(-1)
+    {
+        for(int i = 0; i < perfCounterCount; i++)
+            descriptors[i] = -1;
+
+#ifdef __linux__
+        static const unsigned long long configs[perfCounterCount] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+        for(int i = 0; i < perfCounterCount; i++)
+        {
+            perf_event_attr attributes;
+            memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = configs[i];
+            attributes.disabled = (leader == -1);
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            //this thread, on any cpu
+            descriptors[i] = syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0);
+            if(descriptors[i] == -1 && failure.empty())
+                failure = std::string(perfCounterName(i)) + ": " + strerror(errno);
+            if(descriptors[i] != -1 && ioctl(descriptors[i], PERF_EVENT_IOC_ID, &ids[i]) != 0)
+            {
+                close(descriptors[i]);
+                descriptors[i] = -1;
+            }
+            if(descriptors[i] != -1 && leader == -1)
+                leader = descriptors[i];
+        }
+#else
+        failure = "perf_event_open needs Linux";
+#endif
+    }
+
+    ~PerfCounterGroup()
+    {
+#ifdef __linux__
+        for(int i = 0; i < perfCounterCount; i++)
+            if(descriptors[i] != -1) close(descriptors[i]);
+#endif
+    }
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    bool available() const {return leader != -1;}
+    const std::string& error() const {return failure;}
+
+    // zeroes the counters and starts counting
+    void start()
+    {
+#ifdef __linux__
+        if(!available()) return;
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // stops counting and returns the counts since start
+    PerfCounts stop()
+    {
+        PerfCounts counts;
+#ifdef __linux__
+        if(!available()) return counts;
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        //nr, time enabled, time running, then a (value, id) pair per counter of the group
+        unsigned long long data[3 + 2 * perfCounterCount];
+        if(read(leader, data, sizeof(data)) < (ssize_t) (3 * sizeof(unsigned long long)))
+            return counts;
+
+        unsigned long long members = data[0], enabled = data[1], running = data[2];
+        if(running == 0) return counts;
+        double scale = (running < enabled) ? (double) enabled / running : 1;
+
+        for(unsigned long long member = 0; member < members && member < perfCounterCount; member++)
+        {
+            unsigned long long value = data[3 + 2 * member], id = data[4 + 2 * member];
+            for(int i = 0; i < perfCounterCount; i++)
+            {
+                if(descriptors[i] != -1 && ids[i] == id)
+                {
+                    counts.measured[i] = true;
+                    counts.values[i] = (unsigned long long) (value * scale);
+                }
+            }
+        }
+#endif
+        return counts;
+    }
+};
+
+// the counter group of the calling thread, opened the first time the thread asks for it
+inline PerfCounterGroup& threadPerfCounters()
+{
+    static thread_local PerfCounterGroup group;
+    return group;
+}
+
+#endif
@@ -35,6 +35,7 @@ double pick(double a,double b){
 //Calculate the points inside and on the boundary of the polygon by checking all the points in a square.A lot of computing time but couldnt find something
 //faster.
 double Pick(Polygon_2 poly){
+  SCOPED_TIMER(timerPick);
   double a=0;
   double b=0;
   points add;
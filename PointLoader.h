@@ -0,0 +1,391 @@
+#ifndef POINT_LOADER_H
+#define POINT_LOADER_H
+
+#include "shared.h"
+
+#include <string>
+#include <cstring>
+#include <stdexcept>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef EVALUATE_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef EVALUATE_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+/*
+    Point files always have 2 comment lines, the second one carrying the convex hull area as {"area": "<value>"},
+    followed by one "<index> <x> <y>" line per point.
+    The functions below parse such a file in a single pass, straight out of a memory mapped buffer or out of a decompression stream.
+*/
+
+// returns the start of the line after <cur>
+inline const char* skipLine(const char* cur, const char* end)
+{
+    const char* newline = (const char*) memchr(cur, '\n', end - cur);
+    return (newline == nullptr) ? end : newline + 1;
+}
+
+// parses a (possibly negative) integer at <cur>, skipping spaces and tabs before it. Does not cross lines
+inline bool parseInteger(const char*& cur, const char* end, long& value)
+{
+    while(cur != end && (*cur == ' ' || *cur == '\t' || *cur == '\r')) cur++;
+
+    bool negative = false;
+    if(cur != end && (*cur == '-' || *cur == '+'))
+    {
+        negative = (*cur == '-');
+        cur++;
+    }
+
+    if(cur == end || *cur < '0' || *cur > '9') return false;
+
+    long result = 0;
+    while(cur != end && *cur >= '0' && *cur <= '9')
+    {
+        result = result * 10 + (*cur - '0');
+        cur++;
+    }
+
+    value = negative ? -result : result;
+    return true;
+}
+
+// reads the 2 comment lines at <cur> and returns the convex hull area stored in the second one
+inline long parsePointHeader(const char*& cur, const char* end)
+{
+    cur = skipLine(cur, end);
+    const char* lineEnd = skipLine(cur, end);
+
+    static const char key[] = "{\"area\": \"";
+    const size_t keyLength = sizeof(key) - 1;
+
+    const char* found = nullptr;
+    for(const char* it = cur; it + keyLength <= lineEnd; it++)
+    {
+        if(!memcmp(it, key, keyLength))
+        {
+            found = it + keyLength;
+            break;
+        }
+    }
+
+    long convexHullArea;
+    if(found == nullptr || !parseInteger(found, lineEnd, convexHullArea))
+        throw std::runtime_error("Point file header does not contain the convex hull area");
+
+    cur = lineEnd;
+    return convexHullArea;
+}
+
+// reads "<index> <x> <y>" lines from <cur> up to <end> and appends them to <points>. Incomplete lines are skipped
+inline void parsePointRecords(const char*& cur, const char* end, PointList& points)
+{
+    while(cur != end)
+    {
+        const char* lineEnd = skipLine(cur, end);
+        long index, x, y;
+
+        if(parseInteger(cur, lineEnd, index) && parseInteger(cur, lineEnd, x) && parseInteger(cur, lineEnd, y))
+            points.push_back(Point_2(x, y));
+
+        cur = lineEnd;
+    }
+}
+
+// parses a whole point file held in memory
+inline void parsePointBuffer(const char* begin, const char* end, int& size, PointList& points, long& convexHullArea)
+{
+    const char* cur = begin;
+    convexHullArea = parsePointHeader(cur, end);
+
+    //every point line has roughly the length of the first one, so the byte size gives a close estimate of the point count
+    size_t firstLineLength = skipLine(cur, end) - cur;
+    if(firstLineLength > 0)
+    {
+        size_t estimate = (end - cur) / firstLineLength;
+        points.reserve(points.size() + estimate + estimate / 8 + 1);
+    }
+
+    parsePointRecords(cur, end, points);
+    size = points.size();
+}
+
+/*
+    PointStreamParser parses a point file that arrives in chunks, e.g. out of a decompressor.
+    Complete lines are parsed as soon as they arrive and only the trailing partial line is kept between chunks.
+*/
+class PointStreamParser
+{
+private:
+    std::string pending;
+    size_t expectedBytes;   // the uncompressed size of the file if known, 0 otherwise
+    size_t headerBytes;
+    bool headerParsed;
+    bool reserved;
+    PointList& points;
+    long& convexHullArea;
+
+public:
+    PointStreamParser(PointList& points, long& convexHullArea, size_t expectedBytes):
+        expectedBytes(expectedBytes), headerBytes(0), headerParsed(false), reserved(false), points(points), convexHullArea(convexHullArea){};
+
+    void feed(const char*, size_t);
+    void finish(int&);
+};
+
+void PointStreamParser::feed(const char* data, size_t length)
+{
+    pending.append(data, length);
+
+    const char* begin = pending.data();
+    const char* end = begin + pending.size();
+    const char* cur = begin;
+
+    if(!headerParsed)
+    {
+        const char* firstNewline = (const char*) memchr(begin, '\n', end - begin);
+        if(firstNewline == nullptr || memchr(firstNewline + 1, '\n', end - firstNewline - 1) == nullptr)
+            return;
+
+        convexHullArea = parsePointHeader(cur, end);
+        headerBytes = cur - begin;
+        headerParsed = true;
+    }
+
+    const char* lastNewline = (const char*) memrchr(cur, '\n', end - cur);
+    if(lastNewline == nullptr)
+    {
+        pending.erase(0, cur - begin);
+        return;
+    }
+
+    if(!reserved && expectedBytes > headerBytes)
+    {
+        size_t firstLineLength = skipLine(cur, end) - cur;
+        size_t estimate = (expectedBytes - headerBytes) / firstLineLength;
+        points.reserve(points.size() + estimate + estimate / 8 + 1);
+        reserved = true;
+    }
+
+    parsePointRecords(cur, lastNewline + 1, points);
+    pending.erase(0, cur - begin);
+}
+
+void PointStreamParser::finish(int& size)
+{
+    const char* cur = pending.data();
+    const char* end = cur + pending.size();
+
+    if(!headerParsed)
+    {
+        convexHullArea = parsePointHeader(cur, end);
+        headerParsed = true;
+    }
+
+    parsePointRecords(cur, end, points);
+    pending.clear();
+    size = points.size();
+}
+
+/*
+    fingerprintPoints hashes (FNV-1a) the coordinates of a parsed point set in their input order.
+    Identical instances get the same fingerprint whatever file or bundle they were read from.
+*/
+inline uint64_t fingerprintPoints(const PointList& points)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for(auto it = points.begin(); it != points.end(); ++it)
+    {
+        double coordinates[2] = {CGAL::to_double(it->x()), CGAL::to_double(it->y())};
+        const unsigned char* bytes = (const unsigned char*) coordinates;
+
+        for(size_t i = 0; i < sizeof(coordinates); i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+inline bool hasExtension(const std::string& path, const char* extension)
+{
+    size_t length = strlen(extension);
+    return path.size() >= length && !path.compare(path.size() - length, length, extension);
+}
+
+static const size_t decompressionChunk = 1 << 16;
+
+// streams a gzip compressed point file through zlib into <points>
+void getPointsFromGzipFile(std::string filepath, int& size, PointList& points, long& convexHullArea)
+{
+#ifdef EVALUATE_WITH_ZLIB
+    //the gzip trailer stores the uncompressed size modulo 2^32, good enough for a reserve hint
+    size_t expectedBytes = 0;
+    std::ifstream trailer(filepath, std::ios::binary | std::ios::ate);
+    if(trailer && trailer.tellg() >= 4)
+    {
+        unsigned char isize[4];
+        trailer.seekg(-4, std::ios::end);
+        if(trailer.read((char*) isize, 4))
+            expectedBytes = isize[0] | (isize[1] << 8) | (isize[2] << 16) | ((size_t) isize[3] << 24);
+    }
+    trailer.close();
+
+    gzFile file = gzopen(filepath.c_str(), "rb");
+    if(file == nullptr)
+        throw std::runtime_error("Could not open point file " + filepath);
+    gzbuffer(file, decompressionChunk);
+
+    PointStreamParser parser(points, convexHullArea, expectedBytes);
+    std::unique_ptr<char[]> buffer(new char[decompressionChunk]);
+
+    try
+    {
+        int read;
+        while((read = gzread(file, buffer.get(), decompressionChunk)) > 0)
+            parser.feed(buffer.get(), read);
+
+        if(read < 0)
+        {
+            int error;
+            throw std::runtime_error("Could not decompress point file " + filepath + ": " + gzerror(file, &error));
+        }
+
+        parser.finish(size);
+    }
+    catch(...)
+    {
+        gzclose(file);
+        throw;
+    }
+
+    gzclose(file);
+#else
+    (void) size; (void) points; (void) convexHullArea;
+    throw std::runtime_error("Could not read " + filepath + ": evaluate was built without gzip support (EVALUATE_WITH_ZLIB)");
+#endif
+}
+
+// streams a zstd compressed point file through libzstd into <points>
+void getPointsFromZstdFile(std::string filepath, int& size, PointList& points, long& convexHullArea)
+{
+#ifdef EVALUATE_WITH_ZSTD
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if(fd < 0)
+        throw std::runtime_error("Could not open point file " + filepath);
+
+    ZSTD_DCtx* context = ZSTD_createDCtx();
+    size_t inSize = ZSTD_DStreamInSize();
+    size_t outSize = ZSTD_DStreamOutSize();
+    std::unique_ptr<char[]> in(new char[inSize]);
+    std::unique_ptr<char[]> out(new char[outSize]);
+
+    try
+    {
+        ssize_t read = ::read(fd, in.get(), inSize);
+
+        //the frame header usually carries the uncompressed size, use it as a reserve hint
+        size_t expectedBytes = 0;
+        if(read > 0)
+        {
+            unsigned long long contentSize = ZSTD_getFrameContentSize(in.get(), read);
+            if(contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize != ZSTD_CONTENTSIZE_ERROR)
+                expectedBytes = contentSize;
+        }
+
+        PointStreamParser parser(points, convexHullArea, expectedBytes);
+
+        //the last ZSTD_decompressStream result, 0 once a frame is complete and flushed
+        size_t pending = 0;
+        for(; read > 0; read = ::read(fd, in.get(), inSize))
+        {
+            ZSTD_inBuffer input = {in.get(), (size_t) read, 0};
+            bool outputFull;
+            do
+            {
+                ZSTD_outBuffer output = {out.get(), outSize, 0};
+                pending = ZSTD_decompressStream(context, &output, &input);
+                if(ZSTD_isError(pending))
+                    throw std::runtime_error("Could not decompress point file " + filepath + ": " + ZSTD_getErrorName(pending));
+
+                parser.feed(out.get(), output.pos);
+                outputFull = (output.pos == output.size);
+            }while(input.pos < input.size || outputFull);
+        }
+
+        if(read < 0)
+            throw std::runtime_error("Could not read point file " + filepath);
+        if(pending != 0)
+            throw std::runtime_error("Could not decompress point file " + filepath + ": unexpected end of file");
+
+        parser.finish(size);
+    }
+    catch(...)
+    {
+        ZSTD_freeDCtx(context);
+        close(fd);
+        throw;
+    }
+
+    ZSTD_freeDCtx(context);
+    close(fd);
+#else
+    (void) size; (void) points; (void) convexHullArea;
+    throw std::runtime_error("Could not read " + filepath + ": evaluate was built without zstd support (EVALUATE_WITH_ZSTD)");
+#endif
+}
+
+// reads a point file, compressed files are picked by their .gz or .zst extension and decompressed in memory
+void getPointsFromFile(std::string filepath, int& size, PointList& points, long& convexHullArea)
+{
+    if(hasExtension(filepath, ".gz"))
+        return getPointsFromGzipFile(filepath, size, points, convexHullArea);
+    if(hasExtension(filepath, ".zst"))
+        return getPointsFromZstdFile(filepath, size, points, convexHullArea);
+
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if(fd < 0)
+        throw std::runtime_error("Could not open point file " + filepath);
+
+    struct stat info;
+    if(fstat(fd, &info) < 0 || info.st_size == 0)
+    {
+        close(fd);
+        throw std::runtime_error("Could not read point file " + filepath);
+    }
+
+    size_t length = info.st_size;
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  //the mapping stays valid after closing the descriptor
+
+    if(mapped == MAP_FAILED)
+        throw std::runtime_error("Could not map point file " + filepath);
+
+    madvise(mapped, length, MADV_SEQUENTIAL);
+
+    const char* begin = (const char*) mapped;
+    try
+    {
+        parsePointBuffer(begin, begin + length, size, points, convexHullArea);
+    }
+    catch(...)
+    {
+        munmap(mapped, length);
+        throw;
+    }
+
+    munmap(mapped, length);
+}
+
+#endif
@@ -0,0 +1,209 @@
+#include "PolygonDump.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+struct DumpRecord
+{
+    int fileId;
+    std::string tag;
+    const char* stage;  // nullptr for a file name record, stored in tag
+    std::vector<double> coordinates;
+};
+
+static std::atomic<bool> enabled(false);
+static bool stopping = false;
+static FILE* output = nullptr;
+
+static std::mutex queueLock;
+static std::condition_variable queueReady;
+static std::condition_variable queueSpace;
+static std::vector<DumpRecord> queue;
+static size_t queuedValues = 0;     // coordinates held by the queue
+static std::thread writer;
+
+//past this many queued coordinates (32MB) producers wait for the writer, so a slow disk can not grow the queue without bound
+static const size_t dumpQueueLimit = 1 << 22;
+
+static std::string dumpError;       // the first failed write, reported when the dump is closed
+
+static thread_local int contextFileId = -1;
+static thread_local std::string contextTag;
+
+static void appendNumber(std::string& buffer, double value)
+{
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+}
+
+static void appendNumber(std::string& buffer, int value)
+{
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+}
+
+// formats a whole batch into one buffer, so every batch costs a single write
+static void formatBatch(std::vector<DumpRecord>& batch, std::string& buffer)
+{
+    for(auto it = batch.begin(); it != batch.end(); ++it)
+    {
+        if(it->stage == nullptr)
+        {
+            buffer += "# ";
+            appendNumber(buffer, it->fileId);
+            buffer += '\t';
+            buffer += it->tag;
+            buffer += '\n';
+            continue;
+        }
+
+        appendNumber(buffer, it->fileId);
+        buffer += '\t';
+        buffer += it->tag;
+        buffer += '\t';
+        buffer += it->stage;
+        buffer += "\tPOLYGON((";
+
+        std::vector<double>& coordinates = it->coordinates;
+        for(size_t i = 0; i < coordinates.size(); i += 2)
+        {
+            appendNumber(buffer, coordinates[i]);
+            buffer += ' ';
+            appendNumber(buffer, coordinates[i + 1]);
+            buffer += ',';
+        }
+
+        //WKT polygons are closed by repeating the first vertex
+        if(!coordinates.empty())
+        {
+            appendNumber(buffer, coordinates[0]);
+            buffer += ' ';
+            appendNumber(buffer, coordinates[1]);
+        }
+        buffer += "))\n";
+    }
+}
+
+static void drainQueue()
+{
+    std::vector<DumpRecord> batch;
+    std::string buffer;
+
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> guard(queueLock);
+            queueReady.wait(guard, []{return stopping || !queue.empty();});
+            if(queue.empty())
+                return;
+            batch.swap(queue);
+            queuedValues = 0;
+        }
+        queueSpace.notify_all();
+
+        formatBatch(batch, buffer);
+        if(fwrite(buffer.data(), 1, buffer.size(), output) != buffer.size() && dumpError.empty())
+            dumpError = strerror(errno);
+
+        batch.clear();
+        buffer.clear();
+    }
+}
+
+static void enqueue(DumpRecord& record)
+{
+    {
+        std::unique_lock<std::mutex> guard(queueLock);
+        queueSpace.wait(guard, []{return queuedValues < dumpQueueLimit;});
+        queuedValues += record.coordinates.size();
+        queue.push_back(std::move(record));
+    }
+    queueReady.notify_one();
+}
+
+void openPolygonDump(std::string path)
+{
+    output = fopen(path.c_str(), "w");
+    if(output == nullptr)
+        throw std::runtime_error("Could not open dump file " + path);
+
+    stopping = false;
+    queuedValues = 0;
+    dumpError.clear();
+    writer = std::thread(drainQueue);
+    enabled = true;
+}
+
+void closePolygonDump()
+{
+    if(!enabled)
+        return;
+
+    enabled = false;
+    {
+        std::lock_guard<std::mutex> guard(queueLock);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    writer.join();
+
+    if(fclose(output) != 0 && dumpError.empty())
+        dumpError = strerror(errno);
+    output = nullptr;
+
+    if(!dumpError.empty())
+        fprintf(stderr, "The polygon dump is incomplete, writing it failed: %s\n", dumpError.c_str());
+}
+
+bool polygonDumpEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void setPolygonDumpContext(int fileId, std::string tag)
+{
+    contextFileId = fileId;
+    contextTag = tag;
+}
+
+void dumpFileName(int fileId, std::string name)
+{
+    if(!polygonDumpEnabled())
+        return;
+
+    DumpRecord record;
+    record.fileId = fileId;
+    record.tag = name;
+    record.stage = nullptr;
+    enqueue(record);
+}
+
+void dumpPolygon(const Polygon_2& poly, const char* stage)
+{
+    if(!polygonDumpEnabled())
+        return;
+
+    DumpRecord record;
+    record.fileId = contextFileId;
+    record.tag = contextTag;
+    record.stage = stage;
+
+    record.coordinates.reserve(2 * poly.size());
+    for(auto it = poly.vertices_begin(); it != poly.vertices_end(); ++it)
+    {
+        record.coordinates.push_back(CGAL::to_double(it->x()));
+        record.coordinates.push_back(CGAL::to_double(it->y()));
+    }
+
+    enqueue(record);
+}
@@ -0,0 +1,28 @@
+#ifndef POLYGON_DUMP_H
+#define POLYGON_DUMP_H
+
+#include "shared.h"
+#include <string>
+
+/*
+    Opt-in sink for the polygons produced during a run (-dump <file>).
+    Generators and optimizers only copy their polygon into a queue, a background writer thread drains it in batches
+    and appends one line per polygon to the dump file:
+
+        <file id>\t<combination tag>\t<stage>\tPOLYGON((x y,...))
+
+    The queue is bounded: when the writer falls behind, producers wait for it rather than growing the queue without limit.
+    A failed write is reported once, when the sink is closed. When the sink is not opened, dumpPolygon returns immediately.
+*/
+
+void openPolygonDump(std::string);
+void closePolygonDump();
+bool polygonDumpEnabled();
+
+// the file id and combination tag attached to the polygons dumped from the calling thread
+void setPolygonDumpContext(int, std::string);
+
+void dumpFileName(int, std::string);
+void dumpPolygon(const Polygon_2&, const char*);
+
+#endif
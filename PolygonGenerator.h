@@ -2,14 +2,19 @@
 #define POLYGON_GENERATOR_H
 
 #include "shared.h"
+#include "CancellationToken.h"
 
 class PolygonGenerator
 {
 protected:
     PointList& list;  //constant pointer to the list of points.
+    const CancellationToken* cancellation;  //polled in the loops of the algorithm, may be null
+
+    bool cancelled(){return cancellation != nullptr && cancellation->expired();}
 
 public:
-    PolygonGenerator(PointList& input): list(input){};
+    PolygonGenerator(PointList& input): list(input), cancellation(nullptr){};
+    void setCancellation(const CancellationToken* token){cancellation = token;}
     virtual Polygon_2 generatePolygon() = 0;    //sub classes must implent this class
     virtual ~PolygonGenerator(){};
 };
@@ -2,14 +2,19 @@
 #define POLYGON_OPTIMIZER_H
 
 #include "shared.h"
+#include "CancellationToken.h"
 
 class PolygonOptimizer
 {
 protected:
     Polygon_2& poly;  //constant pointer to the suboptimal polygon created.
+    const CancellationToken* cancellation;  //polled in the loops of the algorithm, may be null
+
+    bool cancelled(){return cancellation != nullptr && cancellation->expired();}
 
 public:
-    PolygonOptimizer(Polygon_2& suboptimalPoly): poly(suboptimalPoly){};
+    PolygonOptimizer(Polygon_2& suboptimalPoly): poly(suboptimalPoly), cancellation(nullptr){};
+    void setCancellation(const CancellationToken* token){cancellation = token;}
     virtual Polygon_2 optimalPolygon() = 0;    //sub classes must implent this class
     virtual ~PolygonOptimizer(){};
 };
@@ -0,0 +1,30 @@
+#ifndef RANDOM_SOURCE_H
+#define RANDOM_SOURCE_H
+
+#include <random>
+#include <cstdlib>
+
+/*
+    The random source of the generators and optimizers. Every thread owns its own engine, so runs on different threads
+    neither share nor reseed each other's sequence, and a run can be repeated exactly by seeding its thread first.
+    Unseeded engines start from std::random_device, like the old srand(time(NULL)) calls but without two runs in the
+    same second drawing the same sequence.
+*/
+inline std::mt19937& randomEngine()
+{
+    static thread_local std::mt19937 engine(std::random_device{}());
+    return engine;
+}
+
+inline void seedRandom(unsigned long seed)
+{
+    randomEngine().seed(seed);
+}
+
+// drop-in replacement for rand(), uniform in [0, RAND_MAX]
+inline int randomInt()
+{
+    return std::uniform_int_distribution<int>(0, RAND_MAX)(randomEngine());
+}
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "shared.h"
+#include "ResultLogger.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <functional>
+#include <cstdio>
+#include <atomic>
+#include <cinttypes>
+#include <stdexcept>
+#include <filesystem>
+
+#include <unistd.h>
+
+/*
+    ResultCache stores the outcome of every run in a directory (-cache <directory>), one file per run, named after
+        <point set fingerprint>-<combination>-<min|max>-<parameter signature>[-s<trial seed>]
+    so a rerun of the same instance with the same strategy and parameters, under any file name, reuses the stored result.
+    Seeded runs (-seed or -trials) carry the seed of their trial, so they only reuse results of the same seed and trial.
+    Each file holds the score, the timings and the final polygon of the run:
+
+        # evaluate cache 3
+        <score> <duration ms> <generation ms> <generation cpu ms> <optimization ms> <optimization cpu ms>
+        <vertex count>
+        <x> <y>     one line per vertex
+
+    Files are written to a temporary name and renamed into place, so concurrent workers and processes never see a partial entry.
+    The cache only saves time: when an entry can not be written (a full disk, a read-only directory) a warning is printed once
+    and the evaluation goes on without storing any more entries.
+*/
+
+static const char cacheHeader[] = "# evaluate cache 3";
+
+class ResultCache
+{
+private:
+    std::string directory;
+    std::atomic<bool> storeFailed;
+
+public:
+    ResultCache(std::string directory);
+
+    std::string key(uint64_t, Combination, OptimizationType, std::string, bool, unsigned long);
+
+    bool lookup(const std::string&, RunResult&, Polygon_2&);
+    void store(const std::string&, const RunResult&, const Polygon_2&);
+};
+
+ResultCache::ResultCache(std::string directory): directory(directory), storeFailed(false)
+{
+    std::filesystem::create_directories(directory);
+}
+
+// the key of a run, with the seed of its trial when the run is <seeded>
+std::string ResultCache::key(uint64_t fingerprint, Combination combination, OptimizationType type, std::string signature, bool seeded, unsigned long seed)
+{
+    std::string key = string_format("%016" PRIx64 "-%d-%s-", fingerprint, (int) combination, (type == minimization) ? "min" : "max") + signature;
+    return seeded ? key + string_format("-s%016lx", seed) : key;
+}
+
+// reads the entry stored under <key>, returns false if there is none or it is unreadable
+bool ResultCache::lookup(const std::string& key, RunResult& result, Polygon_2& polygon)
+{
+    FILE* file = fopen((directory + "/" + key).c_str(), "r");
+    if(file == nullptr)
+        return false;
+
+    char header[sizeof(cacheHeader) + 1];
+    int count;
+    bool valid = fgets(header, sizeof(header), file) != nullptr && std::string(header) == std::string(cacheHeader) + "\n"
+        && fscanf(file, "%la %ld %la %la %la %la %d", &result.score, &result.duration, &result.generationTime, &result.generationCpuTime,
+            &result.optimizationTime, &result.optimizationCpuTime, &count) == 7 && count >= 0;
+
+    polygon.clear();
+    for(int i = 0; valid && i < count; i++)
+    {
+        double x, y;
+        valid = fscanf(file, "%la %la", &x, &y) == 2;
+        if(valid)
+            polygon.push_back(Point_2(x, y));
+    }
+
+    fclose(file);
+    result.cutoff = false;
+    result.cached = true;
+    return valid;
+}
+
+void ResultCache::store(const std::string& key, const RunResult& result, const Polygon_2& polygon)
+{
+    if(storeFailed)
+        return;
+
+    std::string path = directory + "/" + key;
+    std::string temporary = path + string_format(".%d.%zx.tmp", (int) getpid(), std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    FILE* file = fopen(temporary.c_str(), "w");
+    if(file == nullptr)
+    {
+        if(!storeFailed.exchange(true))
+            fprintf(stderr, "Could not write cache entry %s, runs are no longer cached\n", temporary.c_str());
+        return;
+    }
+
+    fprintf(file, "%s\n%a %ld %a %a %a %a\n%d\n", cacheHeader, result.score, result.duration, result.generationTime, result.generationCpuTime,
+        result.optimizationTime, result.optimizationCpuTime, (int) polygon.size());
+    for(auto it = polygon.vertices_begin(); it != polygon.vertices_end(); ++it)
+        fprintf(file, "%a %a\n", CGAL::to_double(it->x()), CGAL::to_double(it->y()));
+
+    bool written = !ferror(file);
+    written = (fclose(file) == 0) && written;
+
+    if(!written || rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        if(!storeFailed.exchange(true))
+            fprintf(stderr, "Could not write cache entry %s, runs are no longer cached\n", path.c_str());
+    }
+}
+
+#endif
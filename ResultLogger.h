@@ -1,12 +1,22 @@
 #ifndef RESULT_LOGGER_H
 #define RESULT_LOGGER_H
 
+#include "shared.h"
+
 #include <string>
 #include <map>
+#include <tuple>
+#include <vector>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include <memory>
 #include <stdexcept>
+#include <algorithm>
+#include <cstdio>
+#include <array>
+#include <mutex>
+#include <atomic>
 
 template<typename ... Args>
 std::string string_format( const std::string& format, Args ... args )
@@ -27,6 +37,8 @@ struct ResultEntry
     double max_score;
     double min_bound;
     double max_bound;
+    long min_count;     // number of runs summed in min_score
+    long max_count;     // number of runs summed in max_score
 };
 
 enum Combination
@@ -89,10 +101,96 @@ std::string combinationShortName(Combination combo)
 
 typedef std::map<int, ResultEntry*> Dictionary;
 
+// every trial of one combination with one objective on the instances of one size, kept when running with -trials
+struct TrialStats
+{
+    long count;
+    double sum;
+    double sumSquares;
+    double best;
+    double worst;
+    std::vector<long> durations;   // milliseconds, one per trial
+};
+
+typedef std::map<std::tuple<int, int, int>, TrialStats> TrialDictionary;   // (size, combination, objective)
+
+// time spent in the two phases of every run of one combination on the instances of one size, summed over both objectives
+struct PhaseTimes
+{
+    long runs;
+    double generationTime;      // wall milliseconds
+    double generationCpuTime;   // thread CPU milliseconds
+    double optimizationTime;
+    double optimizationCpuTime;
+};
+
+typedef std::map<std::pair<int, int>, PhaseTimes> TimingDictionary;         // (size, combination)
+
+// operations counted in the runs of one combination with one objective on one file, kept with -stats
+struct OperationStats
+{
+    long runs;
+    double scoreSum;
+    OpCounts counts;
+};
+
+typedef std::map<std::tuple<std::string, int, int, int>, OperationStats> OperationDictionary;  // (file, size, combination, objective)
+
+// hardware counters of the runs of one combination with one objective on one file, kept with -perfcounters
+struct HardwareStats
+{
+    long runs;
+    double scoreSum;
+    long counted[perfCounterCount];                 // runs that measured each counter
+    unsigned long long values[perfCounterCount];
+};
+
+typedef std::map<std::tuple<std::string, int, int, int>, HardwareStats> HardwareDictionary;    // (file, size, combination, objective)
+
+/*
+    In concurrent mode (setConcurrent) every thread that reports a result gets its own accumulator of sums, counts and bounds,
+    registered once and then updated without any locking. The accumulators are folded into the table when concurrent mode
+    is switched off, after the workers are done, so threads reporting at the same time never wait on each other.
+*/
+struct alignas(64) ResultAccumulator
+{
+    std::map<int, std::array<ResultEntry, 7>> log;
+    TrialDictionary trialLog;
+    TimingDictionary timingLog;
+    OperationDictionary operationLog;
+    HardwareDictionary hardwareLog;
+};
+
 class ResultLogger
 {
 private:
     Dictionary log; 
+    TrialDictionary trialLog;
+    TimingDictionary timingLog;
+    OperationDictionary operationLog;
+    HardwareDictionary hardwareLog;
+    int trials;
+    bool operationStats;
+    bool hardwareStats;
+
+    bool concurrent;
+    unsigned long id;                                               // tells apart the accumulators of different loggers
+    std::mutex accumulatorLock;                                     // only taken when a thread registers its accumulator
+    std::vector<std::unique_ptr<ResultAccumulator>> accumulators;
+
+    void ensureEntry(int);
+    ResultEntry* entriesOf(int);
+    void mergeEntry(int, int, const ResultEntry&);
+    static void mergeTrial(TrialDictionary&, int, int, int, const TrialStats&);
+    static void mergeTiming(TimingDictionary&, int, int, const PhaseTimes&);
+    static void mergeOperations(OperationDictionary&, const std::tuple<std::string, int, int, int>&, const OperationStats&);
+    static void mergeHardware(HardwareDictionary&, const std::tuple<std::string, int, int, int>&, const HardwareStats&);
+    ResultAccumulator& localAccumulator();
+    void gather();
+    void printTrials(std::ofstream&);
+    void printTimings(std::ofstream&);
+    void printOperations(std::ofstream&);
+    void printHardware(std::ofstream&);
 public:
     ResultLogger();
     ~ResultLogger();
@@ -100,17 +198,42 @@ public:
     void updateEntry(int, Combination, double, double);
     void updateMinEntry(int, Combination, double);
     void updateMaxEntry(int, Combination, double);
+    void updateTrial(int, Combination, int, double, long);
+    void updateTiming(int, Combination, const RunResult&);
+    void updateOperations(const std::string&, int, Combination, int, const RunResult&);
+    void setOperationStats(bool enabled){operationStats = enabled;}
+    void updateHardware(const std::string&, int, Combination, int, const RunResult&);
+    void setHardwareStats(bool enabled){hardwareStats = enabled;}
+    void setTrials(int count){trials = count;}
+    void setConcurrent(bool);
     void printLogger(std::string);
+
+    void writePartial(std::string);
+    void mergePartial(std::string);
 };
 
-ResultLogger::ResultLogger(){}
+// a new owner id for the per-thread accumulators, never reused
+unsigned long nextAccumulatorOwner()
+{
+    static std::atomic<unsigned long> owners(0);
+    return ++owners;
+}
+
+ResultLogger::ResultLogger(): trials(1), operationStats(false), hardwareStats(false), concurrent(false), id(nextAccumulatorOwner()){}
+
 ResultLogger::~ResultLogger()
 {
     for(auto it = log.begin(); it != log.end(); it++)
         delete [] log[it->first];
 }
 
-void ResultLogger::updateEntry(int key, Combination combination, double minScore, double maxScore)
+// an entry no run has been added to yet
+ResultEntry emptyEntry()
+{
+    return {0, 0, -1, 2, 0, 0};
+}
+
+void ResultLogger::ensureEntry(int key)
 {
     if(log.find(key) == log.end())
     {
@@ -118,32 +241,321 @@ void ResultLogger::updateEntry(int key, Combination combination, double minScore
         log[key] = new ResultEntry[7];
         
         for(int i = 0; i < 7; i++)
-        {
-            log[key][i].min_score = 0;
-            log[key][i].max_score = 0;
-            log[key][i].min_bound = -1;
-            log[key][i].max_bound = 2;
-        }
+            log[key][i] = emptyEntry();
     }
+}
+
+// adds the sums, counts and bounds of <entry> to those of <combination> for size <key>
+void ResultLogger::mergeEntry(int key, int combination, const ResultEntry& entry)
+{
+    ensureEntry(key);
+    ResultEntry& merged = log[key][combination];
+
+    merged.min_score += entry.min_score;
+    merged.max_score += entry.max_score;
+    merged.min_bound = std::max(merged.min_bound, entry.min_bound);
+    merged.max_bound = std::min(merged.max_bound, entry.max_bound);
+    merged.min_count += entry.min_count;
+    merged.max_count += entry.max_count;
+}
+
+// the accumulator of the calling thread, registered on its first result
+ResultAccumulator& ResultLogger::localAccumulator()
+{
+    static thread_local unsigned long owner = 0;
+    static thread_local ResultAccumulator* accumulator = nullptr;
+
+    if(owner != id)
+    {
+        std::lock_guard<std::mutex> guard(accumulatorLock);
+        accumulators.push_back(std::unique_ptr<ResultAccumulator>(new ResultAccumulator()));
+        accumulator = accumulators.back().get();
+        owner = id;
+    }
+    return *accumulator;
+}
+
+// folds every accumulator into the table, in the order the threads registered
+void ResultLogger::gather()
+{
+    std::lock_guard<std::mutex> guard(accumulatorLock);
+
+    for(auto it = accumulators.begin(); it != accumulators.end(); ++it)
+    {
+        for(auto entry = (*it)->log.begin(); entry != (*it)->log.end(); ++entry)
+            for(int i = 0; i < 7; i++)
+                if(entry->second[i].min_count > 0 || entry->second[i].max_count > 0)
+                    mergeEntry(entry->first, i, entry->second[i]);
+
+        for(auto trial = (*it)->trialLog.begin(); trial != (*it)->trialLog.end(); ++trial)
+            mergeTrial(trialLog, std::get<0>(trial->first), std::get<1>(trial->first), std::get<2>(trial->first), trial->second);
+
+        for(auto timing = (*it)->timingLog.begin(); timing != (*it)->timingLog.end(); ++timing)
+            mergeTiming(timingLog, timing->first.first, timing->first.second, timing->second);
+
+        for(auto operations = (*it)->operationLog.begin(); operations != (*it)->operationLog.end(); ++operations)
+            mergeOperations(operationLog, operations->first, operations->second);
+
+        for(auto hardware = (*it)->hardwareLog.begin(); hardware != (*it)->hardwareLog.end(); ++hardware)
+            mergeHardware(hardwareLog, hardware->first, hardware->second);
+    }
+
+    accumulators.clear();
+}
 
+/*
+    Switches the concurrent mode on or off. Switching it off folds the per-thread accumulators into the table,
+    so it must only happen once no thread reports results anymore.
+*/
+void ResultLogger::setConcurrent(bool enabled)
+{
+    if(concurrent && !enabled)
+    {
+        gather();
+
+        //threads that registered with this logger must register again if it goes concurrent once more
+        id = nextAccumulatorOwner();
+    }
+    concurrent = enabled;
+}
+
+// the entries of size <key> that results are added to, the ones of the calling thread in concurrent mode
+ResultEntry* ResultLogger::entriesOf(int key)
+{
+    if(!concurrent)
+    {
+        ensureEntry(key);
+        return log[key];
+    }
+
+    auto& local = localAccumulator().log;
+    auto found = local.find(key);
+    if(found == local.end())
+    {
+        found = local.emplace(key, std::array<ResultEntry, 7>()).first;
+        found->second.fill(emptyEntry());
+    }
+    return found->second.data();
+}
+
+void ResultLogger::updateEntry(int key, Combination combination, double minScore, double maxScore)
+{
     updateMinEntry(key, combination, minScore);
     updateMaxEntry(key, combination, maxScore);
 }
 
 void ResultLogger::updateMinEntry(int key, Combination combination, double minScore)
 {
-    log[key][combination].min_score += minScore;
+    ResultEntry* entries = entriesOf(key);
+    entries[combination].min_score += minScore;
+    entries[combination].min_count++;
 
-    double prevMinBound = log[key][combination].min_bound;
-    log[key][combination].min_bound = std::max(prevMinBound, minScore);
+    double prevMinBound = entries[combination].min_bound;
+    entries[combination].min_bound = std::max(prevMinBound, minScore);
 }
 
 void ResultLogger::updateMaxEntry(int key, Combination combination, double maxScore)
 {
-    log[key][combination].max_score += maxScore;
+    ResultEntry* entries = entriesOf(key);
+    entries[combination].max_score += maxScore;
+    entries[combination].max_count++;
+
+    double prevMaxBound = entries[combination].max_bound;
+    entries[combination].max_bound = std::min(prevMaxBound, maxScore);
+}
+
+// adds a single trial of <combination> with objective <type> (an OptimizationType) to the trial statistics of size <key>
+void ResultLogger::updateTrial(int key, Combination combination, int type, double score, long duration)
+{
+    TrialStats trial = {1, score, score * score, score, score, {duration}};
+    mergeTrial(concurrent ? localAccumulator().trialLog : trialLog, key, combination, type, trial);
+}
+
+void ResultLogger::mergeTrial(TrialDictionary& trialLog, int key, int combination, int type, const TrialStats& trial)
+{
+    auto found = trialLog.find(std::make_tuple(key, combination, type));
+    if(found == trialLog.end())
+    {
+        trialLog[std::make_tuple(key, combination, type)] = trial;
+        return;
+    }
+
+    //the best score is the lowest one when minimizing and the highest one when maximizing
+    bool minimizing = (type == minimization);
+    TrialStats& stats = found->second;
+    stats.count += trial.count;
+    stats.sum += trial.sum;
+    stats.sumSquares += trial.sumSquares;
+    stats.best = minimizing ? std::min(stats.best, trial.best) : std::max(stats.best, trial.best);
+    stats.worst = minimizing ? std::max(stats.worst, trial.worst) : std::min(stats.worst, trial.worst);
+    stats.durations.insert(stats.durations.end(), trial.durations.begin(), trial.durations.end());
+}
+
+// adds the phase times of one run of <combination> to those of size <key>
+void ResultLogger::updateTiming(int key, Combination combination, const RunResult& result)
+{
+    PhaseTimes times = {1, result.generationTime, result.generationCpuTime, result.optimizationTime, result.optimizationCpuTime};
+    mergeTiming(concurrent ? localAccumulator().timingLog : timingLog, key, combination, times);
+}
+
+void ResultLogger::mergeTiming(TimingDictionary& timingLog, int key, int combination, const PhaseTimes& times)
+{
+    PhaseTimes& merged = timingLog.emplace(std::make_pair(key, combination), PhaseTimes{0, 0, 0, 0, 0}).first->second;
+    merged.runs += times.runs;
+    merged.generationTime += times.generationTime;
+    merged.generationCpuTime += times.generationCpuTime;
+    merged.optimizationTime += times.optimizationTime;
+    merged.optimizationCpuTime += times.optimizationCpuTime;
+}
+
+// adds the operations counted in one run of <combination> with objective <type> on <file> (of size <key>), if -stats is on and the run executed
+void ResultLogger::updateOperations(const std::string& file, int key, Combination combination, int type, const RunResult& result)
+{
+    if(!operationStats || result.cached)
+        return;
+
+    OperationStats stats = {1, result.score, result.operations};
+    mergeOperations(concurrent ? localAccumulator().operationLog : operationLog, std::make_tuple(file, key, (int) combination, type), stats);
+}
+
+void ResultLogger::mergeOperations(OperationDictionary& operationLog, const std::tuple<std::string, int, int, int>& key, const OperationStats& stats)
+{
+    OperationStats& merged = operationLog.emplace(key, OperationStats{0, 0, OpCounts()}).first->second;
+    merged.runs += stats.runs;
+    merged.scoreSum += stats.scoreSum;
+    merged.counts += stats.counts;
+}
+
+// adds the hardware counters of one run of <combination> with objective <type> on <file> (of size <key>), if -perfcounters is on and the run measured any
+void ResultLogger::updateHardware(const std::string& file, int key, Combination combination, int type, const RunResult& result)
+{
+    if(!hardwareStats || !result.hardware.any())
+        return;
+
+    HardwareStats stats = {1, result.score, {}, {}};
+    for(int i = 0; i < perfCounterCount; i++)
+    {
+        stats.counted[i] = result.hardware.measured[i];
+        stats.values[i] = result.hardware.values[i];
+    }
+    mergeHardware(concurrent ? localAccumulator().hardwareLog : hardwareLog, std::make_tuple(file, key, (int) combination, type), stats);
+}
+
+void ResultLogger::mergeHardware(HardwareDictionary& hardwareLog, const std::tuple<std::string, int, int, int>& key, const HardwareStats& stats)
+{
+    HardwareStats& merged = hardwareLog.emplace(key, HardwareStats{0, 0, {}, {}}).first->second;
+    merged.runs += stats.runs;
+    merged.scoreSum += stats.scoreSum;
+    for(int i = 0; i < perfCounterCount; i++)
+    {
+        merged.counted[i] += stats.counted[i];
+        merged.values[i] += stats.values[i];
+    }
+}
+
+// nearest rank percentile of sorted <values>
+long percentile(const std::vector<long>& values, double rank)
+{
+    if(values.empty()) return 0;
+    size_t index = (size_t) std::ceil(rank / 100 * values.size());
+    return values[(index > 0) ? index - 1 : 0];
+}
+
+void ResultLogger::printTrials(std::ofstream& outputStream)
+{
+    outputStream << std::endl << "Trials per file: " << trials << std::endl;
+    outputStream << "Size\t||\tCombination\t\t\t\t\t||\tobjective\t||\truns\t\t||\tmean\t\t||\tstd dev\t\t||\tbest\t\t||\tworst\t\t||\tp50 ms\t\t||\tp90 ms\t\t||\tp99 ms\t\t||" << std::endl;
+
+    for(auto iter = trialLog.begin(); iter != trialLog.end(); iter++)
+    {
+        const TrialStats& stats = iter->second;
+        double mean = stats.sum / stats.count;
+        double variance = (stats.count > 1) ? (stats.sumSquares - stats.sum * mean) / (stats.count - 1) : 0;
+
+        std::vector<long> durations = stats.durations;
+        std::sort(durations.begin(), durations.end());
+
+        outputStream << string_format("%-8d||%-40s||%14s||", std::get<0>(iter->first), combinationShortName((Combination) std::get<1>(iter->first)).c_str(),
+            (std::get<2>(iter->first) == minimization) ? "min" : "max");
+        outputStream << string_format("%14ld||%14.4f||%14.4f||%14.4f||%14.4f||", stats.count, mean, std::sqrt(std::max(variance, 0.0)), stats.best, stats.worst);
+        outputStream << string_format("%14ld||%14ld||%14ld||", percentile(durations, 50), percentile(durations, 90), percentile(durations, 99)) << std::endl;
+    }
+}
+
+/*
+    Mean time per run spent generating the initial polygon and optimizing it, in wall and in thread CPU time.
+    Wall time well above CPU time means the phase was waiting rather than computing, e.g. on the other threads of a parallel run.
+*/
+void ResultLogger::printTimings(std::ofstream& outputStream)
+{
+    outputStream << std::endl << "Mean time per run (ms)" << std::endl;
+    outputStream << "Size\t||\tCombination\t\t\t\t\t||\truns\t\t||\tgeneration\t||\tgeneration cpu\t||\toptimization\t||\toptimization cpu||" << std::endl;
+
+    for(auto iter = timingLog.begin(); iter != timingLog.end(); iter++)
+    {
+        const PhaseTimes& times = iter->second;
+        if(times.runs == 0) continue;
+
+        outputStream << string_format("%-8d||%-40s||", iter->first.first, combinationShortName((Combination) iter->first.second).c_str());
+        outputStream << string_format("%14ld||%14.3f||%14.3f||%14.3f||%14.3f||", times.runs, times.generationTime / times.runs, times.generationCpuTime / times.runs,
+            times.optimizationTime / times.runs, times.optimizationCpuTime / times.runs) << std::endl;
+    }
+}
+
+// the operations every file needed per combination and objective, summed over its trials, next to its mean score
+void ResultLogger::printOperations(std::ofstream& outputStream)
+{
+    outputStream << std::endl << "Operations per file" << std::endl;
+    outputStream << "Size\t||\tCombination\t\t\t\t\t||\tobjective\t||\truns\t\t||\tscore\t\t||";
+    for(int i = 0; i < opCounterCount; i++)
+        outputStream << string_format("%18s||", opCounterName(i));
+    outputStream << "\tfile" << std::endl;
 
-    double prevMaxBound = log[key][combination].max_bound;
-    log[key][combination].max_bound = std::min(prevMaxBound, maxScore);
+    for(auto iter = operationLog.begin(); iter != operationLog.end(); iter++)
+    {
+        const OperationStats& stats = iter->second;
+
+        outputStream << string_format("%-8d||%-40s||%14s||", std::get<1>(iter->first), combinationShortName((Combination) std::get<2>(iter->first)).c_str(),
+            (std::get<3>(iter->first) == minimization) ? "min" : "max");
+        outputStream << string_format("%14ld||%14.4f||", stats.runs, stats.scoreSum / stats.runs);
+        for(int i = 0; i < opCounterCount; i++)
+            outputStream << string_format("%18llu||", stats.counts.values[i]);
+        outputStream << "\t" << std::get<0>(iter->first) << std::endl;
+    }
+}
+
+/*
+    Instructions per cycle and the hardware counters per point of every file, per combination and objective, next to its mean score.
+    A counter the machine could not measure is shown as "-".
+*/
+void ResultLogger::printHardware(std::ofstream& outputStream)
+{
+    outputStream << std::endl << "Hardware counters per file" << std::endl;
+    outputStream << "Size\t||\tCombination\t\t\t\t\t||\tobjective\t||\truns\t\t||\tscore\t\t||\tIPC\t\t\t||";
+    for(int i = 0; i < perfCounterCount; i++)
+        if(i != perfInstructions) outputStream << string_format("%18s||", (std::string(perfCounterName(i)) + "/point").c_str());
+    outputStream << "\tfile" << std::endl;
+
+    for(auto iter = hardwareLog.begin(); iter != hardwareLog.end(); iter++)
+    {
+        const HardwareStats& stats = iter->second;
+        int size = std::get<1>(iter->first);
+
+        outputStream << string_format("%-8d||%-40s||%14s||", size, combinationShortName((Combination) std::get<2>(iter->first)).c_str(),
+            (std::get<3>(iter->first) == minimization) ? "min" : "max");
+        outputStream << string_format("%14ld||%14.4f||", stats.runs, stats.scoreSum / stats.runs);
+
+        //both counters must come from the same runs for their ratio to mean anything
+        bool ipc = stats.counted[perfCycles] == stats.counted[perfInstructions] && stats.counted[perfCycles] > 0 && stats.values[perfCycles] > 0;
+        outputStream << (ipc ? string_format("%14.3f||", (double) stats.values[perfInstructions] / stats.values[perfCycles]) : "\t\t-\t\t||");
+
+        for(int i = 0; i < perfCounterCount; i++)
+        {
+            if(i == perfInstructions) continue;
+            outputStream << ((stats.counted[i] > 0) ? string_format("%18.1f||", (double) stats.values[i] / ((double) stats.counted[i] * size)) : "\t\t-\t\t||");
+        }
+        outputStream << "\t" << std::get<0>(iter->first) << std::endl;
+    }
 }
 
 void ResultLogger::printLogger(std::string streamName)
@@ -182,7 +594,227 @@ void ResultLogger::printLogger(std::string streamName)
 
     }
 
+    if(!timingLog.empty())
+        printTimings(outputStream);
+
+    if(trials > 1)
+        printTrials(outputStream);
+
+    if(operationStats)
+        printOperations(outputStream);
+
+    if(hardwareStats)
+        printHardware(outputStream);
+}
+
+static const char partialHeader[] = "# evaluate partial results 5";
+
+/*
+    writePartial stores the raw state of the logger, so that the loggers of several shards can be merged into one table later.
+    Every table line holds "<size> <combination> <min score> <max score> <min bound> <max bound> <min count> <max count>",
+    with the sums and bounds in hexadecimal floating point so that they survive the round trip exactly.
+    With -trials, a "K <trials>" line and one "T <size> <combination> <objective> <count> <sum> <sum of squares> <best> <worst> <durations>"
+    line per trial statistic follow, the durations separated by commas.
+    Every "P <size> <combination> <runs> <generation ms> <generation cpu ms> <optimization ms> <optimization cpu ms>" line holds summed phase times.
+    With -stats, an "O" line follows and every "S <size> <combination> <objective> <runs> <score sum> <counters> <file>" line holds the operations of one file.
+    With -perfcounters, a "W" line follows and every "H <size> <combination> <objective> <runs> <score sum> <runs counted> <value> ... <file>" line
+    holds the hardware counters of one file, a (runs counted, value) pair per counter.
+*/
+void ResultLogger::writePartial(std::string streamName)
+{
+    std::ofstream outputStream(streamName);
+    if(!outputStream)
+        throw std::runtime_error("Could not create partial results file " + streamName);
 
+    outputStream << partialHeader << std::endl;
+
+    for(auto iter = log.begin(); iter != log.end(); iter++)
+    {
+        ResultEntry *logNode = iter->second;
+        for(int i = 0; i < 7; i++)
+        {
+            outputStream << string_format("%d %d %a %a %a %a %ld %ld", iter->first, i, logNode[i].min_score, logNode[i].max_score,
+                logNode[i].min_bound, logNode[i].max_bound, logNode[i].min_count, logNode[i].max_count) << std::endl;
+        }
+    }
+
+    for(auto iter = timingLog.begin(); iter != timingLog.end(); iter++)
+    {
+        const PhaseTimes& times = iter->second;
+        outputStream << string_format("P %d %d %ld %a %a %a %a", iter->first.first, iter->first.second, times.runs, times.generationTime, times.generationCpuTime,
+            times.optimizationTime, times.optimizationCpuTime) << std::endl;
+    }
+
+    if(operationStats)
+    {
+        outputStream << "O" << std::endl;
+
+        for(auto iter = operationLog.begin(); iter != operationLog.end(); iter++)
+        {
+            const OperationStats& stats = iter->second;
+            outputStream << string_format("S %d %d %d %ld %a", std::get<1>(iter->first), std::get<2>(iter->first), std::get<3>(iter->first), stats.runs, stats.scoreSum);
+            for(int i = 0; i < opCounterCount; i++)
+                outputStream << " " << stats.counts.values[i];
+            outputStream << " " << std::get<0>(iter->first) << std::endl;
+        }
+    }
+
+    if(hardwareStats)
+    {
+        outputStream << "W" << std::endl;
+
+        for(auto iter = hardwareLog.begin(); iter != hardwareLog.end(); iter++)
+        {
+            const HardwareStats& stats = iter->second;
+            outputStream << string_format("H %d %d %d %ld %a", std::get<1>(iter->first), std::get<2>(iter->first), std::get<3>(iter->first), stats.runs, stats.scoreSum);
+            for(int i = 0; i < perfCounterCount; i++)
+                outputStream << " " << stats.counted[i] << " " << stats.values[i];
+            outputStream << " " << std::get<0>(iter->first) << std::endl;
+        }
+    }
+
+    if(trials > 1)
+    {
+        outputStream << "K " << trials << std::endl;
+
+        for(auto iter = trialLog.begin(); iter != trialLog.end(); iter++)
+        {
+            const TrialStats& stats = iter->second;
+            outputStream << string_format("T %d %d %d %ld %a %a %a %a ", std::get<0>(iter->first), std::get<1>(iter->first), std::get<2>(iter->first),
+                stats.count, stats.sum, stats.sumSquares, stats.best, stats.worst);
+
+            for(size_t i = 0; i < stats.durations.size(); i++)
+                outputStream << ((i > 0) ? "," : "") << stats.durations[i];
+            outputStream << std::endl;
+        }
+    }
+
+    if(!outputStream)
+        throw std::runtime_error("Could not write partial results file " + streamName);
+}
+
+// adds the results of a file written by writePartial to the logger, as if its runs had been logged here
+void ResultLogger::mergePartial(std::string streamName)
+{
+    std::ifstream inputStream(streamName);
+    std::string line;
+
+    if(!std::getline(inputStream, line) || line != partialHeader)
+        throw std::runtime_error("Not a partial results file: " + streamName);
+
+    while(std::getline(inputStream, line))
+    {
+        if(line.empty())
+            continue;
+
+        if(line[0] == 'K')
+        {
+            trials = std::max(trials, atoi(line.c_str() + 1));
+            continue;
+        }
+
+        if(line[0] == 'O')
+        {
+            operationStats = true;
+            continue;
+        }
+
+        if(line[0] == 'S')
+        {
+            int key, combination, type, consumed = -1;
+            OperationStats stats;
+            if(sscanf(line.c_str(), "S %d %d %d %ld %la%n", &key, &combination, &type, &stats.runs, &stats.scoreSum, &consumed) != 5 || consumed < 0
+                || combination < 0 || combination >= 7)
+                throw std::runtime_error("Corrupted partial results file " + streamName + ": " + line);
+
+            for(int i = 0; i < opCounterCount; i++)
+            {
+                int read = -1;
+                if(sscanf(line.c_str() + consumed, " %llu%n", &stats.counts.values[i], &read) != 1 || read < 0)
+                    throw std::runtime_error("Corrupted partial results file " + streamName + ": " + line);
+                consumed += read;
+            }
+
+            if(line[consumed] != ' ')
+                throw std::runtime_error("Corrupted partial results file " + streamName + ": " + line);
+
+            mergeOperations(operationLog, std::make_tuple(line.substr(consumed + 1), key, combination, type), stats);
+            continue;
+        }
+
+        if(line[0] == 'W')
+        {
+            hardwareStats = true;
+            continue;
+        }
+
+        if(line[0] == 'H')
+        {
+            int key, combination, type, consumed = -1;
+            HardwareStats stats;
+            if(sscanf(line.c_str(), "H %d %d %d %ld %la%n", &key, &combination, &type, &stats.runs, &stats.scoreSum, &consumed) != 5 || consumed < 0
+                || combination < 0 || combination >= 7)
+                throw std::runtime_error("Corrupted partial results file " + streamName + ": " + line);
+
+            for(int i = 0; i < perfCounterCount; i++)
+            {
+                int read = -1;
+                if(sscanf(line.c_str() + consumed, " %ld %llu%n", &stats.counted[i], &stats.values[i], &read) != 2 || read < 0)
+                    throw std::runtime_error("Corrupted partial results file " + streamName + ": " + line);
+                consumed += read;
+            }
+
+            if(line[consumed] != ' ')
+                throw std::runtime_error("Corrupted partial results file " + streamName + ": " + line);
+
+            mergeHardware(hardwareLog, std::make_tuple(line.substr(consumed + 1), key, combination, type), stats);
+            continue;
+        }
+
+        if(line[0] == 'P')
+        {
+            int key, combination;
+            PhaseTimes times;
+            if(sscanf(line.c_str(), "P %d %d %ld %la %la %la %la", &key, &combination, &times.runs, &times.generationTime, &times.generationCpuTime,
+                &times.optimizationTime, &times.optimizationCpuTime) != 7 || combination < 0 || combination >= 7)
+                throw std::runtime_error("Corrupted partial results file " + streamName + ": " + line);
+
+            mergeTiming(timingLog, key, combination, times);
+            continue;
+        }
+
+        if(line[0] == 'T')
+        {
+            int key, combination, type, consumed = -1;
+            TrialStats stats;
+            if(sscanf(line.c_str(), "T %d %d %d %ld %la %la %la %la %n", &key, &combination, &type, &stats.count, &stats.sum, &stats.sumSquares,
+                &stats.best, &stats.worst, &consumed) != 8 || consumed < 0 || combination < 0 || combination >= 7)
+                throw std::runtime_error("Corrupted partial results file " + streamName + ": " + line);
+
+            for(const char* cur = line.c_str() + consumed; *cur != '\0'; )
+            {
+                char* next;
+                stats.durations.push_back(strtol(cur, &next, 10));
+                cur = (*next == ',') ? next + 1 : next;
+                if(next == cur && *cur != '\0')
+                    throw std::runtime_error("Corrupted partial results file " + streamName + ": " + line);
+            }
+
+            mergeTrial(trialLog, key, combination, type, stats);
+            continue;
+        }
+
+        int key, combination;
+        double minScore, maxScore, minBound, maxBound;
+        long minCount, maxCount;
+
+        //%la reads both hexadecimal and decimal floating point
+        if(sscanf(line.c_str(), "%d %d %la %la %la %la %ld %ld", &key, &combination, &minScore, &maxScore, &minBound, &maxBound, &minCount, &maxCount) != 8
+            || combination < 0 || combination >= 7)
+            throw std::runtime_error("Corrupted partial results file " + streamName + ": " + line);
+
+        mergeEntry(key, combination, {minScore, maxScore, minBound, maxBound, minCount, maxCount});
+    }
 }
 
 #endif
\ No newline at end of file
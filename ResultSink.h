@@ -0,0 +1,122 @@
+#ifndef RESULT_SINK_H
+#define RESULT_SINK_H
+
+#include "shared.h"
+#include "ResultLogger.h"
+#include "PointLoader.h"
+#include "JsonString.h"
+
+#include <string>
+#include <mutex>
+#include <cstdio>
+#include <stdexcept>
+
+/*
+    ResultSink streams one record per finished run (-results <file>) for tools that ingest results directly.
+    A .csv file gets a header row and one comma separated row per run, any other extension gets JSON Lines, one object per run.
+    Every record carries
+
+        file, size, combination, objective, trial, score, generation_ms, generation_cpu_ms, optimization_ms, optimization_cpu_ms, duration_ms, cutoff, cached,
+        peak_rss_delta_kb, allocations, allocated_bytes, heap_peak_bytes, ant_polygons, ant_level_polygons, ant_graph_nodes, ant_path_entries, local_changes
+
+    (the memory of the run, see MemoryStats.h) and is flushed as soon as it is written, so the file can be followed while the evaluation runs.
+*/
+
+// one finished run, as written to the sink
+struct RunRecord
+{
+    std::string file;
+    int size;
+    Combination combination;
+    OptimizationType type;
+    int trial;
+    RunResult result;
+};
+
+class ResultSink
+{
+private:
+    FILE* output;
+    bool csv;
+    std::mutex lock;
+
+    static std::string quoteCsv(const std::string&);
+
+public:
+    ResultSink(std::string path, bool append);
+    ~ResultSink(){fclose(output);}
+
+    ResultSink(const ResultSink&) = delete;
+    ResultSink& operator=(const ResultSink&) = delete;
+
+    void write(const RunRecord&);
+};
+
+// opens the sink at <path>, appending to it when resuming an evaluation
+ResultSink::ResultSink(std::string path, bool append): csv(hasExtension(path, ".csv"))
+{
+    output = fopen(path.c_str(), append ? "a" : "w");
+    if(output == nullptr)
+        throw std::runtime_error("Could not open results file " + path);
+
+    //an appended csv already has its header
+    if(csv && ftell(output) == 0)
+    {
+        std::string header = "file,size,combination,objective,trial,score,generation_ms,generation_cpu_ms,optimization_ms,optimization_cpu_ms,duration_ms,cutoff,cached,"
+            "peak_rss_delta_kb,allocations,allocated_bytes,heap_peak_bytes";
+        for(int i = 0; i < memoryMarkCount; i++)
+            header += std::string(",") + memoryMarkName(i);
+
+        fputs((header + "\n").c_str(), output);
+        fflush(output);
+    }
+}
+
+std::string ResultSink::quoteCsv(const std::string& text)
+{
+    std::string quoted = "\"";
+    for(auto it = text.begin(); it != text.end(); ++it)
+    {
+        if(*it == '"') quoted += '"';
+        quoted += *it;
+    }
+    return quoted + "\"";
+}
+
+void ResultSink::write(const RunRecord& record)
+{
+    const RunResult& result = record.result;
+    const char* objective = (record.type == minimization) ? "min" : "max";
+    const MemoryUsage& memory = result.memory;
+    std::string line;
+
+    if(csv)
+    {
+        line = quoteCsv(record.file) + string_format(",%d,", record.size) + quoteCsv(combinationShortName(record.combination))
+            + string_format(",%s,%d,%.17g,%.3f,%.3f,%.3f,%.3f,%ld,%d,%d", objective, record.trial, result.score, result.generationTime, result.generationCpuTime,
+                result.optimizationTime, result.optimizationCpuTime, result.duration, (int) result.cutoff, (int) result.cached)
+            + string_format(",%ld,%llu,%llu,%lld", memory.peakRssDelta, memory.allocations, memory.allocatedBytes, memory.heapPeakBytes);
+        for(int i = 0; i < memoryMarkCount; i++)
+            line += string_format(",%llu", memory.marks[i]);
+        line += "\n";
+    }
+    else
+    {
+        line = "{\"file\":" + quoteJson(record.file) + string_format(",\"size\":%d,\"combination\":", record.size) + quoteJson(combinationShortName(record.combination))
+            + string_format(",\"objective\":\"%s\",\"trial\":%d,\"score\":%.17g,\"generation_ms\":%.3f,\"generation_cpu_ms\":%.3f,\"optimization_ms\":%.3f,"
+                "\"optimization_cpu_ms\":%.3f,\"duration_ms\":%ld,\"cutoff\":%s,\"cached\":%s",
+                objective, record.trial, result.score, result.generationTime, result.generationCpuTime, result.optimizationTime, result.optimizationCpuTime, result.duration,
+                result.cutoff ? "true" : "false", result.cached ? "true" : "false")
+            + string_format(",\"peak_rss_delta_kb\":%ld,\"allocations\":%llu,\"allocated_bytes\":%llu,\"heap_peak_bytes\":%lld",
+                memory.peakRssDelta, memory.allocations, memory.allocatedBytes, memory.heapPeakBytes);
+        for(int i = 0; i < memoryMarkCount; i++)
+            line += string_format(",\"%s\":%llu", memoryMarkName(i), memory.marks[i]);
+        line += "}\n";
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    fputs(line.c_str(), output);
+    fflush(output);
+}
+
+#endif
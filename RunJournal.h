@@ -0,0 +1,233 @@
+#ifndef RUN_JOURNAL_H
+#define RUN_JOURNAL_H
+
+#include "shared.h"
+#include "ResultLogger.h"
+
+#include <string>
+#include <vector>
+#include <set>
+#include <tuple>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/*
+    RunJournal is an append-only log of finished runs (-journal <file>), so a killed evaluation can be resumed with -resume.
+    The first line records the settings the journal was written with, then every finished run appends one line:
+
+        R\t<size>\t<combination>\t<min|max>\t<trial>\t<score>\t<duration ms>\t<cutoff>\t<generation ms>\t<generation cpu ms>\t<optimization ms>\t<optimization cpu ms>\t<file name>
+
+    Lines are written as soon as a run finishes and fsynced in batches. On resume a torn last line, left by a crash in the middle
+    of a write, is cut off and every complete line is replayed.
+*/
+
+// one finished run of a combination with one objective on one file
+struct JournalRecord
+{
+    std::string file;
+    int size;
+    Combination combination;
+    OptimizationType type;
+    int trial;
+    RunResult result;
+};
+
+static const char journalHeader[] = "# evaluate journal 3 ";
+static const int journalSyncBatch = 64;                                 // records between two fsyncs
+static const std::chrono::milliseconds journalSyncInterval(1000);      // or time between two fsyncs, whatever comes first
+
+class RunJournal
+{
+private:
+    std::string path;
+    int fd;
+    std::vector<JournalRecord> replayed;
+    std::set<std::tuple<std::string, int, int, int>> finished;
+
+    std::mutex lock;
+    int unsynced;
+    std::chrono::steady_clock::time_point lastSync;
+
+    void replay(std::string);
+    void writeAll(const std::string&);
+
+public:
+    RunJournal(std::string path, std::string settings, bool resume);
+    ~RunJournal();
+
+    RunJournal(const RunJournal&) = delete;
+    RunJournal& operator=(const RunJournal&) = delete;
+
+    // the runs read back from the journal on resume
+    const std::vector<JournalRecord>& records(){return replayed;}
+
+    bool done(const std::string&, Combination, OptimizationType, int);
+    bool doneAll(const std::string&, int, int);
+
+    void append(const JournalRecord&);
+    void sync();
+};
+
+/*
+    Opens the journal at <path>. <settings> describes the options that change the scores (e.g. the preprocessing strategy),
+    resuming a journal written with other settings is refused. Without <resume> a journal that already holds something is refused too,
+    so a rerun can not wipe the work of an earlier one.
+*/
+RunJournal::RunJournal(std::string path, std::string settings, bool resume): path(path), fd(-1), unsynced(0)
+{
+    std::string header = journalHeader + settings;
+    bool exists = resume && access(path.c_str(), F_OK) == 0;
+
+    if(exists)
+    {
+        fd = open(path.c_str(), O_RDWR);
+        if(fd < 0)
+            throw std::runtime_error("Could not open journal " + path);
+
+        replay(header);
+    }
+    else
+    {
+        struct stat existing;
+        if(!resume && stat(path.c_str(), &existing) == 0 && existing.st_size > 0)
+            throw std::runtime_error("Journal " + path + " already exists, continue it with -resume or remove it");
+
+        fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0)
+            throw std::runtime_error("Could not create journal " + path);
+
+        writeAll(header + "\n");
+        fsync(fd);
+    }
+
+    lseek(fd, 0, SEEK_END);
+    lastSync = std::chrono::steady_clock::now();
+}
+
+RunJournal::~RunJournal()
+{
+    if(fd >= 0)
+    {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+/*
+    Reads back every record. A crash can only tear the last line, so an unreadable last line is cut off,
+    while an unreadable line followed by other lines means the journal is damaged and is refused.
+*/
+void RunJournal::replay(std::string header)
+{
+    std::string contents;
+    char buffer[1 << 16];
+    ssize_t read;
+    while((read = ::read(fd, buffer, sizeof(buffer))) > 0)
+        contents.append(buffer, read);
+
+    size_t lineEnd = contents.find('\n');
+    if(lineEnd == std::string::npos || contents.compare(0, lineEnd, header) != 0)
+        throw std::runtime_error("Journal " + path + " was not written with the current settings (" + header + ")");
+
+    size_t valid = lineEnd + 1;
+    while(true)
+    {
+        lineEnd = contents.find('\n', valid);
+        if(lineEnd == std::string::npos)
+            break;
+
+        std::string line = contents.substr(valid, lineEnd - valid);
+        JournalRecord record;
+        int combination, cutoff, nameStart = -1;
+        char type[4];
+
+        RunResult& result = record.result;
+        if(sscanf(line.c_str(), "R\t%d\t%d\t%3s\t%d\t%la\t%ld\t%d\t%la\t%la\t%la\t%la\t%n", &record.size, &combination, type, &record.trial,
+            &result.score, &result.duration, &cutoff, &result.generationTime, &result.generationCpuTime, &result.optimizationTime, &result.optimizationCpuTime,
+            &nameStart) != 11 || nameStart < 0 || combination < 0 || combination >= 7)
+        {
+            if(contents.find('\n', lineEnd + 1) == std::string::npos)
+                break;
+            throw std::runtime_error("Journal " + path + " is damaged, record " + std::to_string(replayed.size() + 1) + " can not be read: " + line);
+        }
+
+        record.combination = (Combination) combination;
+        record.type = (std::string(type) == "min") ? minimization : maximization;
+        result.cutoff = cutoff;
+        result.cached = false;
+        record.file = line.substr(nameStart);
+
+        replayed.push_back(record);
+        finished.insert(std::make_tuple(record.file, (int) record.combination, (int) record.type, record.trial));
+        valid = lineEnd + 1;
+    }
+
+    if(valid < contents.size() && ftruncate(fd, valid) < 0)
+        throw std::runtime_error("Could not truncate journal " + path);
+}
+
+void RunJournal::writeAll(const std::string& data)
+{
+    size_t written = 0;
+    while(written < data.size())
+    {
+        ssize_t result = write(fd, data.data() + written, data.size() - written);
+        if(result < 0)
+            throw std::runtime_error("Could not write journal " + path);
+        written += result;
+    }
+}
+
+bool RunJournal::done(const std::string& file, Combination combination, OptimizationType type, int trial)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return finished.count(std::make_tuple(file, (int) combination, (int) type, trial)) > 0;
+}
+
+// true if every trial of both objectives of the first <comboLimit> combinations has finished on <file>
+bool RunJournal::doneAll(const std::string& file, int comboLimit, int trials)
+{
+    for(int i = 0; i < comboLimit; i++)
+        for(int t = 0; t < trials; t++)
+            if(!done(file, (Combination) i, minimization, t) || !done(file, (Combination) i, maximization, t))
+                return false;
+    return true;
+}
+
+// writes <record> right away, so it survives the process being killed, and fsyncs once a batch is due
+void RunJournal::append(const JournalRecord& record)
+{
+    const RunResult& result = record.result;
+    std::string line = string_format("R\t%d\t%d\t%s\t%d\t%a\t%ld\t%d\t%a\t%a\t%a\t%a\t", record.size, (int) record.combination,
+        (record.type == minimization) ? "min" : "max", record.trial, result.score, result.duration, (int) result.cutoff,
+        result.generationTime, result.generationCpuTime, result.optimizationTime, result.optimizationCpuTime) + record.file + "\n";
+
+    std::lock_guard<std::mutex> guard(lock);
+    writeAll(line);
+    finished.insert(std::make_tuple(record.file, (int) record.combination, (int) record.type, record.trial));
+
+    auto now = std::chrono::steady_clock::now();
+    if(++unsynced >= journalSyncBatch || now - lastSync >= journalSyncInterval)
+    {
+        fdatasync(fd);
+        unsynced = 0;
+        lastSync = now;
+    }
+}
+
+void RunJournal::sync()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    fdatasync(fd);
+    unsynced = 0;
+    lastSync = std::chrono::steady_clock::now();
+}
+
+#endif
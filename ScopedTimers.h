@@ -0,0 +1,187 @@
+#ifndef SCOPED_TIMERS_H
+#define SCOPED_TIMERS_H
+
+#include <chrono>
+#include <algorithm>
+#include <mutex>
+#include <cstdio>
+
+/*
+    Latency distributions of the hot functions, for a build with -DEVALUATE_TIMERS. Without it SCOPED_TIMER and TIMED_CALL compile to nothing.
+
+        SCOPED_TIMER(timer)         times the rest of the enclosing scope
+        TIMED_CALL(timer, call)     times the expression <call> and evaluates to its value
+
+    Every call lands in a log-linear (HDR style) histogram of the calling thread: 16 linear buckets for every power of two
+    of nanoseconds, so a percentile is off by at most 1/16 of its value. The histograms of a thread are merged into the totals
+    when the thread exits, the ones of the main thread by printScopedTimers, which prints p50/p90/p99/max of every timer.
+*/
+
+enum ScopedTimer
+{
+    timerIsReplaceable,     // isReplaceable() of ConvexHullAlgo and IncAlgo
+    timerLocalIsSimple,     // is_simple() of the candidate polygons of LocalAlgo
+    timerValidityLocal,     // validityLocal() of local Simulated Annealing
+    timerGenerateX,         // GenerateX() of Ant
+    timerPick,              // Pick()
+    scopedTimerCount
+};
+
+inline const char* scopedTimerName(int timer)
+{
+    static const char* names[scopedTimerCount] = {"isReplaceable", "LocalAlgo is_simple", "validityLocal", "GenerateX", "Pick"};
+    return names[timer];
+}
+
+class LatencyHistogram
+{
+private:
+    static const int subBuckets = 16;
+    static const int bucketCount = 2 * subBuckets + 59 * subBuckets;
+
+    unsigned long long buckets[bucketCount] = {};
+    unsigned long long calls = 0;
+    unsigned long long maximum = 0;
+    double total = 0;
+
+    // values under 32ns get a bucket each, above that a power of two is split in 16
+    static int bucketOf(unsigned long long nanoseconds)
+    {
+        if(nanoseconds < 2 * subBuckets)
+            return nanoseconds;
+
+        int shift = 63 - __builtin_clzll(nanoseconds) - 4;
+        return 2 * subBuckets + (shift - 1) * subBuckets + (int) ((nanoseconds >> shift) - subBuckets);
+    }
+
+    // the largest value of <bucket>
+    static unsigned long long bucketTop(int bucket)
+    {
+        if(bucket < 2 * subBuckets)
+            return bucket;
+
+        int shift = (bucket - 2 * subBuckets) / subBuckets + 1;
+        unsigned long long mantissa = subBuckets + (bucket - 2 * subBuckets) % subBuckets;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+public:
+    void record(unsigned long long nanoseconds)
+    {
+        buckets[bucketOf(nanoseconds)]++;
+        calls++;
+        total += nanoseconds;
+        if(nanoseconds > maximum) maximum = nanoseconds;
+    }
+
+    void merge(const LatencyHistogram& other)
+    {
+        for(int i = 0; i < bucketCount; i++) buckets[i] += other.buckets[i];
+        calls += other.calls;
+        total += other.total;
+        if(other.maximum > maximum) maximum = other.maximum;
+    }
+
+    // the value under which a <fraction> of the calls fall, rounded up to the top of its bucket
+    unsigned long long percentile(double fraction) const
+    {
+        unsigned long long rank = (unsigned long long) (fraction * calls + 0.999999), seen = 0;
+        for(int i = 0; i < bucketCount; i++)
+        {
+            seen += buckets[i];
+            if(seen >= rank && seen > 0)
+                return std::min(bucketTop(i), maximum);
+        }
+        return maximum;
+    }
+
+    unsigned long long count() const {return calls;}
+    unsigned long long max() const {return maximum;}
+    double mean() const {return calls ? total / calls : 0;}
+};
+
+inline std::mutex scopedTimerLock;
+inline LatencyHistogram scopedTimerTotals[scopedTimerCount];
+
+// the histograms of one thread, merged into the totals when it exits
+struct ThreadTimers
+{
+    LatencyHistogram histograms[scopedTimerCount];
+
+    void mergeInto()
+    {
+        std::lock_guard<std::mutex> guard(scopedTimerLock);
+        for(int i = 0; i < scopedTimerCount; i++)
+        {
+            scopedTimerTotals[i].merge(histograms[i]);
+            histograms[i] = LatencyHistogram();
+        }
+    }
+
+    ~ThreadTimers(){mergeInto();}
+};
+
+#ifdef EVALUATE_TIMERS
+
+inline thread_local ThreadTimers threadTimers;
+
+class ScopedTimerGuard
+{
+private:
+    int timer;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    ScopedTimerGuard(int timer): timer(timer), start(std::chrono::steady_clock::now()){}
+    ~ScopedTimerGuard()
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        threadTimers.histograms[timer].record(elapsed);
+    }
+};
+
+template<class Call>
+inline auto timedCall(int timer, Call call)
+{
+    ScopedTimerGuard guard(timer);
+    return call();
+}
+
+#define SCOPED_TIMER_NAME(line) scopedTimer##line
+#define SCOPED_TIMER_AT(timer, line) ScopedTimerGuard SCOPED_TIMER_NAME(line)(timer)
+#define SCOPED_TIMER(timer) SCOPED_TIMER_AT(timer, __LINE__)
+#define TIMED_CALL(timer, call) timedCall(timer, [&]{return call;})
+static const bool scopedTimersEnabled = true;
+
+#else
+
+#define SCOPED_TIMER(timer) ((void) 0)
+#define TIMED_CALL(timer, call) (call)
+static const bool scopedTimersEnabled = false;
+
+#endif
+
+// merges the histograms of the calling thread and prints the totals, nothing in a build without timers
+inline void printScopedTimers(FILE* output)
+{
+#ifdef EVALUATE_TIMERS
+    threadTimers.mergeInto();
+#endif
+    if(!scopedTimersEnabled)
+        return;
+
+    std::lock_guard<std::mutex> guard(scopedTimerLock);
+    fprintf(output, "\nLatency per call (ns)\n");
+    fprintf(output, "%-22s %12s %12s %12s %12s %12s %12s\n", "timer", "calls", "mean", "p50", "p90", "p99", "max");
+    for(int i = 0; i < scopedTimerCount; i++)
+    {
+        const LatencyHistogram& histogram = scopedTimerTotals[i];
+        if(histogram.count() == 0)
+            continue;
+
+        fprintf(output, "%-22s %12llu %12.0f %12llu %12llu %12llu %12llu\n", scopedTimerName(i), histogram.count(), histogram.mean(),
+            histogram.percentile(0.50), histogram.percentile(0.90), histogram.percentile(0.99), histogram.max());
+    }
+}
+
+#endif
@@ -1,4 +1,7 @@
 #include "SimulatedAnnealing.h"
+#include "PolygonDump.h"
+#include "RandomSource.h"
+#include "ConvergenceRecorder.h"
 #include <random>
 #include <algorithm>
 #include <math.h>
@@ -18,7 +21,6 @@ void initializeTree(Tree&, Polygon_2&);
 
 Polygon_2 SimulatedAnnealing::optimalPolygon()
 {
-    std::srand(time(NULL));
 
     // this->poly.clear();
 
@@ -39,22 +41,26 @@ Polygon_2 SimulatedAnnealing::optimalPolygon()
         poly
     );*/
 
+    Polygon_2 optimal;
     switch (annealingType)
     {
     case local:
-        return localAnnealing();
+        optimal = localAnnealing();
         break;
     
     case global:
-        return globalAnnealing();
+        optimal = globalAnnealing();
         break;
     
     case subdivision:
-        return subdivisionAnnealing();
+        optimal = subdivisionAnnealing();
         break;
     default:
-        return poly;
+        optimal = poly;
     }
+
+    dumpPolygon(optimal, "simulated annealing");
+    return optimal;
 }
 
 double minX(Point_2 a, Point_2 b, Point_2 c, Point_2 d)
@@ -105,6 +111,7 @@ Fuzzy_iso_box getQueryBox(Point_2 a, Point_2 b, Point_2 c, Point_2 d)
 
 void getQueryResult(PointList& result, Fuzzy_iso_box query, Tree& tree)
 {
+    COUNT_OP(annealingKdQueries);
     tree.search(std::back_inserter(result), query);
 }
 
@@ -165,6 +172,7 @@ Segment_2 SimulatedAnnealing::getEdgeFromTarget(Point_2 target)
 
 bool SimulatedAnnealing::validityLocal(Point_2 q, Point_2 r, Point_2 s, Point_2 p, Tree& tree)
 {
+    SCOPED_TIMER(timerValidityLocal);
 
     Segment_2 edgePR = Segment_2(p, r);
     Segment_2 edgeQS = Segment_2(q, s);
@@ -319,11 +327,14 @@ Polygon_2 SimulatedAnnealing::localAnnealing()
     Point_2 q, r, s, p;
     PointListIterator qIndex, rIndex, sIndex, pIndex;
 
-    std::default_random_engine generator;
+    std::mt19937& generator = randomEngine();
     std::uniform_real_distribution<double> distribution(0.0,1.0);
 
+    ConvergenceCurve curve("local annealing", optimizationType);
     int iteration = 1;
-    while(T > 0)
+    if(curve.enabled())
+        curve.record(0, energyScore(getEnergy()));
+    while(T > 0 && !cancelled())
     {
         double energyInitial = getEnergy();
         PointListIterator begin = poly.vertices_begin();
@@ -332,9 +343,10 @@ Polygon_2 SimulatedAnnealing::localAnnealing()
         int selection;
 
         //get random valid transition
+        bool valid;
         do
         {
-            selection = rand()%n;
+            selection = randomInt()%n;
             qIndex = begin + selection;
             rIndex = qIndex + 1; if(rIndex == end) rIndex = begin;
             sIndex = rIndex + 1; if(sIndex == end) sIndex = begin;
@@ -346,7 +358,14 @@ Polygon_2 SimulatedAnnealing::localAnnealing()
             p = *(pIndex);
 
             selection = (selection + 1) % n;
-        }while(!validityLocal(q, r, s, p, tree));
+
+            valid = validityLocal(q, r, s, p, tree);
+            if(!valid) COUNT_OP(annealingRejected);
+        }while(!valid && !cancelled());
+
+        //out of time while looking for a valid transition, keep the current polygon
+        if(cancelled())
+            break;
 
         //make transition
         *rIndex = q;
@@ -356,15 +375,16 @@ Polygon_2 SimulatedAnnealing::localAnnealing()
         double DE = energyFinal - energyInitial;
 
         //if energy increased, and Metropolis criterion doesn't hold revert change
-        if(DE >= 0)
+        if(DE >= 0 && exp(-(DE/T)) < distribution(generator))
         {
-            if(exp(-(DE/T)) < distribution(generator))
-            {
-                *rIndex = r;
-                *qIndex = q;
-            }
-                
+            *rIndex = r;
+            *qIndex = q;
+            energyFinal = energyInitial;
+            COUNT_OP(annealingReverted);
         }
+        else
+            COUNT_OP(annealingAccepted);
+        curve.record(iteration++, energyScore(energyFinal));
         
         T = T - (1 / (double)L);    
     }
@@ -379,21 +399,26 @@ Polygon_2 SimulatedAnnealing::globalAnnealing()
     PointListIterator qIndex, rIndex, sIndex, pIndex, tIndex;
     int selectionQ, selectionS;
 
-    std::default_random_engine generator;
+    std::mt19937& generator = randomEngine();
     std::uniform_real_distribution<double> distribution(0.0,1.0);
 
-    while(T > 0)
+    ConvergenceCurve curve("global annealing", optimizationType);
+    long iteration = 1;
+    if(curve.enabled())
+        curve.record(0, energyScore(getEnergy()));
+    while(T > 0 && !cancelled())
     {
         double energyInitial = getEnergy();
         PointListIterator begin = poly.vertices_begin();
         PointListIterator end = poly.vertices_end();
 
         //get random valid transition
+        bool valid;
         do
         {
             //select random q and s
-            selectionQ = rand()%n;
-            do{selectionS = rand()%n;}while(selectionS == selectionQ);
+            selectionQ = randomInt()%n;
+            do{selectionS = randomInt()%n;}while(selectionS == selectionQ);
             
             //get q, p, r, s and t points
             qIndex = begin + selectionQ;
@@ -409,7 +434,13 @@ Polygon_2 SimulatedAnnealing::globalAnnealing()
             p = *(pIndex);
             t = *(tIndex);
 
-        }while(!validityGlobal(q, r, s, p, t));
+            valid = validityGlobal(q, r, s, p, t);
+            if(!valid) COUNT_OP(annealingRejected);
+        }while(!valid && !cancelled());
+
+        //out of time while looking for a valid transition, keep the current polygon
+        if(cancelled())
+            break;
 
         Polygon_2 temp = this->poly;
         moveVertex(qIndex, tIndex, this->poly);
@@ -418,13 +449,15 @@ Polygon_2 SimulatedAnnealing::globalAnnealing()
         double DE = energyFinal - energyInitial;
 
         //if energy increased, and Metropolis criterion doesn't hold revert change
-        if(DE >= 0)
+        if(DE >= 0 && exp(-(DE/T)) < distribution(generator))
         {
-            if(exp(-(DE/T)) < distribution(generator))
-            {
-                moveVertex(tIndex, qIndex, this->poly);
-            }
+            moveVertex(tIndex, qIndex, this->poly);
+            energyFinal = energyInitial;
+            COUNT_OP(annealingReverted);
         }
+        else
+            COUNT_OP(annealingAccepted);
+        curve.record(iteration++, energyScore(energyFinal));
 
         T = T - (1 / (double) L);
     }
@@ -469,6 +502,15 @@ double SimulatedAnnealing::maximizationEnergy()
     return this->n * (1 - (polygonArea() / this->chpArea));
 }
 
+// the score (area / convex hull area) of a polygon with energy <energy>
+double SimulatedAnnealing::energyScore(double energy)
+{
+    if(this->optimizationType == maximization)
+        return 1 - energy / this->n;
+    else
+        return energy / this->n;
+}
+
 double SimulatedAnnealing::polygonArea()
 {
     return abs(this->poly.area());
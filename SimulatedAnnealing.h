@@ -19,6 +19,7 @@ public:
     double minimizationEnergy();
     double maximizationEnergy();
     double getEnergy();
+    double energyScore(double);
     void moveVertex(PointListIterator, PointListIterator, Polygon_2&);
 
     bool validityLocal(Point_2, Point_2, Point_2, Point_2, Tree&);
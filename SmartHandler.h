@@ -15,8 +15,16 @@ class SmartHandler : public AlgorithmHandler{
 private:
     
 public:
+    SmartHandler(): AlgorithmHandler(){};
     SmartHandler(std::string filename): AlgorithmHandler(filename){};
 
+    //bump the version whenever a parameter below changes. The parameters depend on the size of the instance,
+    //which the cache key already covers, and on whether it is a "stars" file
+    virtual std::string parameterSignature()
+    {
+        return (filename.find("stars") != std::string::npos) ? "smart-1-stars" : "smart-1";
+    }
+
     virtual double incrementalLocalSearch(OptimizationType type)
     {
 
@@ -54,10 +62,10 @@ public:
         }
 
         IncAlgo *generator = new IncAlgo(points, Initialization::a1, selection);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         LocalAlgo *optimizer = new LocalAlgo(initial, convexHullArea, threshold, type, L);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -65,11 +73,11 @@ public:
     virtual double incrementalAnnealing(OptimizationType type)
     {
         IncAlgo *generator = new IncAlgo(points, Initialization::a1, EdgeSelection::randomSelection);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         int L = std::min(1000 * ((size / 100) + 1), 4000);
         SimulatedAnnealing *optimizer = new SimulatedAnnealing(initial, convexHullArea, L, type, AnnealingType::local);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -103,10 +111,10 @@ public:
         }
         
         ConvexHullAlgo *generator = new ConvexHullAlgo(points, selection);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         LocalAlgo *optimizer = new LocalAlgo(initial, convexHullArea, threshold, type, L);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -115,11 +123,11 @@ public:
     {
         EdgeSelection selection = (type == OptimizationType::maximization) ? EdgeSelection::max : EdgeSelection::min;
         ConvexHullAlgo *generator = new ConvexHullAlgo(points, selection);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         int L = std::min(1000 * ((size / 100) + 1), 4000);
         SimulatedAnnealing *optimizer = new SimulatedAnnealing(initial, convexHullArea, L, type, AnnealingType::local);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -152,10 +160,10 @@ public:
         }
 
         OnionAlgo *generator = new OnionAlgo(points, 3);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         LocalAlgo *optimizer = new LocalAlgo(initial, convexHullArea, threshold, type, L);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -163,11 +171,11 @@ public:
     virtual double onionAnnealing(OptimizationType type)
     {
         OnionAlgo *generator = new OnionAlgo(points, 1);
-        Polygon_2 initial = generator->generatePolygon();
+        Polygon_2 initial = generate(generator);
 
         int L = std::min(1000 * ((size / 100) + 1), 4000);
         SimulatedAnnealing *optimizer = new SimulatedAnnealing(initial, convexHullArea, L, type, AnnealingType::local);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -198,7 +206,7 @@ public:
         smart.optimizationType=type;
         smart.ro=0.05;
         Ant *optimizer = new Ant(smart, points, dummyPoly);
-        Polygon_2 optimal = (*optimizer).optimalPolygon();
+        Polygon_2 optimal = optimize(optimizer);
 
         return abs(optimal.area()) / convexHullArea;
     }
@@ -0,0 +1,19 @@
+#ifndef THREAD_CLOCK_H
+#define THREAD_CLOCK_H
+
+#include <time.h>
+
+/*
+    CPU time used by the calling thread, next to wall time it tells apart a phase that computes from one that waits
+    (on other threads of a parallel run, on the disk, on the scheduler).
+*/
+
+// milliseconds of CPU time the calling thread has used so far
+inline double threadCpuTime()
+{
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+#endif
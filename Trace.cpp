@@ -0,0 +1,128 @@
+#include "Trace.h"
+#include "JsonString.h"
+
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <stdexcept>
+
+static std::atomic<bool> tracing(false);
+static bool tracingLoops = false;
+static FILE* traceOutput = nullptr;
+static bool firstTraceEvent = true;
+static std::mutex traceLock;
+static std::chrono::steady_clock::time_point traceOrigin;
+static std::thread::id mainTraceThread;    // the thread that opened the trace
+
+static std::atomic<int> nextTraceThread(1);
+static thread_local int traceThread = 0;
+
+static double traceTime()
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - traceOrigin).count();
+}
+
+// writes one event under the lock
+static void writeTraceEvent(const std::string& event)
+{
+    std::lock_guard<std::mutex> guard(traceLock);
+    if(traceOutput == nullptr)
+        return;
+
+    fprintf(traceOutput, "%s%s", firstTraceEvent ? "" : ",\n", event.c_str());
+    firstTraceEvent = false;
+}
+
+// the track of the calling thread, named by a metadata event the first time the thread records a span
+static int traceTrack()
+{
+    if(traceThread != 0)
+        return traceThread;
+
+    traceThread = nextTraceThread++;
+    bool main = std::this_thread::get_id() == mainTraceThread;
+
+    std::string track = main ? "main" : "thread " + std::to_string(traceThread);
+    writeTraceEvent("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(traceThread) + ",\"args\":{\"name\":" + quoteJson(track) + "}}");
+    return traceThread;
+}
+
+void openTrace(std::string path, bool loops)
+{
+    traceOutput = fopen(path.c_str(), "w");
+    if(traceOutput == nullptr)
+        throw std::runtime_error("Could not open trace file " + path);
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", traceOutput);
+    firstTraceEvent = true;
+    tracingLoops = loops;
+    traceOrigin = std::chrono::steady_clock::now();
+    mainTraceThread = std::this_thread::get_id();
+    tracing = true;
+}
+
+void closeTrace()
+{
+    if(!tracing)
+        return;
+
+    tracing = false;
+    std::lock_guard<std::mutex> guard(traceLock);
+    fputs("\n]}\n", traceOutput);
+    fclose(traceOutput);
+    traceOutput = nullptr;
+}
+
+bool traceEnabled()
+{
+    return tracing.load(std::memory_order_relaxed);
+}
+
+bool traceLoopsEnabled()
+{
+    return tracingLoops && traceEnabled();
+}
+
+std::string traceArgument(const char* key, const std::string& value)
+{
+    return quoteJson(key) + ":" + quoteJson(value);
+}
+
+std::string traceArgument(const char* key, long value)
+{
+    return quoteJson(key) + ":" + std::to_string(value);
+}
+
+TraceSpan::TraceSpan(const char* category, const char* name, bool loop): active(loop ? traceLoopsEnabled() : traceEnabled()), category(category)
+{
+    if(!active)
+        return;
+
+    this->name = name;
+    start = traceTime();
+}
+
+TraceSpan::TraceSpan(const char* category, const std::string& name, const std::string& args): active(traceEnabled()), category(category)
+{
+    if(!active)
+        return;
+
+    this->name = name;
+    this->args = args;
+    start = traceTime();
+}
+
+TraceSpan::~TraceSpan()
+{
+    if(!active || !traceEnabled())
+        return;
+
+    double end = traceTime();
+    char timing[96];
+    snprintf(timing, sizeof(timing), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":", start, end - start);
+
+    std::string event = "{\"name\":" + quoteJson(name) + ",\"cat\":" + quoteJson(category) + timing + std::to_string(traceTrack()) + ",\"args\":{" + args + "}}";
+    writeTraceEvent(event);
+}
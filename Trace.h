@@ -0,0 +1,47 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+
+/*
+    Opt-in timeline of an evaluation (-trace <file>) in the Chrome trace event format, which loads in Perfetto or chrome://tracing.
+    Every TraceSpan becomes one complete event ("ph":"X") on the track of the thread that ran it, so spans opened inside
+    other spans of the same thread nest:
+
+        file load           parsing an instance (on the loader threads)
+        run                 one handleAlgorithm call, named after its combination and objective
+        generation, optimization    the phases of a run
+        loop                the rounds of LocalAlgo and the cycles of Ant, only with -traceLoops
+
+    When the trace is not opened, a span costs a single check.
+*/
+
+void openTrace(std::string, bool);
+void closeTrace();
+bool traceEnabled();
+bool traceLoopsEnabled();
+
+// a JSON member for the arguments of a span, like "file":"a.instance"
+std::string traceArgument(const char*, const std::string&);
+std::string traceArgument(const char*, long);
+
+class TraceSpan
+{
+private:
+    bool active;
+    const char* category;
+    std::string name;
+    std::string args;   // comma separated traceArgument members
+    double start;       // microseconds since the trace was opened
+
+public:
+    // a span of an inner loop (<loop>) is only recorded with -traceLoops
+    TraceSpan(const char* category, const char* name, bool loop = false);
+    TraceSpan(const char* category, const std::string& name, const std::string& args);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#endif
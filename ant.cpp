@@ -1,8 +1,12 @@
 #include"ant.h"
+#include "PolygonDump.h"
+#include "Trace.h"
+#include "ConvergenceRecorder.h"
+#include "RandomSource.h"
 #include <climits>
 #include <map>
 #include <ctime>
-int minmax;
+thread_local int minmax;
 Ant::Ant(AntParameters argFlags,PointList list, Polygon_2& poly) : PolygonOptimizer(poly){
   this->argFlags = argFlags;
   this->list=list;
@@ -13,7 +17,7 @@ typedef Kernel::Point_2                                          Point;
 bool isReplaceable(Point_2, Segment_2, Polygon_2&);
 bool IsFeasible(Polygon_2 ,Point );
 int ProbFunction();
-int ph=1;
+thread_local int ph=1;
 std::string convert(Polygon_2);
 
 struct ant
@@ -32,7 +36,7 @@ bool hasbranch=0;
 
 
 
-std::map <std::string,int> Pointpoped;
+thread_local std::map <std::string,int> Pointpoped;
 
 
 double ProbFunction(int a , int b,table tabletop,std::list<table> tablebot)//Prob function that returns the chance of an ant moving to node i
@@ -150,7 +154,7 @@ std::vector<Segment_2> CheckPolAnt(Polygon_2 ,Point ,int );
 
 
 //Generate all the triangles that can be made in the given set of points
-std::vector<Polygon_2> Generate3(std::vector<Point> list){
+std::vector<Polygon_2> Generate3(std::vector<Point> list,const CancellationToken* cancellation){
 Polygon_2 poly;
 int flag=0;
 std::vector<Polygon_2> res;
@@ -158,9 +162,12 @@ std::vector<Polygon_2> res;
 
 for(auto v1=list.begin();v1!=list.end();++v1){
 
-
   for(auto v2=list.begin();v2!=list.end();++v2){
 
+    //out of time, return the triangles found so far
+    if(cancellation!=nullptr && cancellation->expired())
+      return res;
+
     if(v2[0]==v1[0])
     continue;
 
@@ -213,7 +220,8 @@ return res;
 //Generate a list of x-agons
 
 std::vector<Polygon_2> GenerateX(Polygon_2 space,
-std::vector<Point> list, int enable_breaks,int divisor){
+std::vector<Point> list, int enable_breaks,int divisor,const CancellationToken* cancellation){
+SCOPED_TIMER(timerGenerateX);
 double sizecounter[list.size()];
 
 Polygon_2 check;
@@ -237,6 +245,9 @@ std::vector <Segment_2> segs;
 int k=0;
 for (auto v1=list.begin();v1!=list.end();++v1,++k)
 {       
+  //out of time, return the polygons found so far
+  if(cancellation!=nullptr && cancellation->expired())
+    break;
   
   
   
@@ -305,7 +316,7 @@ for (int s=0;s<=k;s++)
 for (int s=0;s<=k;s++)
 {
   flag11=0;
-int var=rand()%2;
+int var=randomInt()%2;
 if(minmax==1){
 double prob =((sum-sizecounter[s])/sizecounter[s])/100;
 
@@ -333,7 +344,7 @@ break;
 }
 else if(k>list.size()/divisor)
 {
-    int var=rand()%2;
+    int var=randomInt()%2;
 
 if(minmax==1){
 double prob =((sum-sizecounter[k])/sizecounter[k])/100;
@@ -416,6 +427,9 @@ double MaxOrMin(int area,int mode)
   
   
 Polygon_2 Ant::optimalPolygon(){
+    //the triangle nodes start from pheromone 1 on every run, whichever runs came before it on this thread
+    ph=1;
+    Pointpoped.clear();
 
     std::vector<Polygon_2> space;
     
@@ -446,7 +460,31 @@ Polygon_2 Ant::optimalPolygon(){
     int elitismpos=0;
     int elitismk=0;
     Polygon_2 BestForCircle;
-    space= Generate3(test);
+    //the containers only grow, so their sizes when the run returns are their high-water marks
+    auto markContainers = [&]{
+        MARK_HIGH(antGraphNodes, table1.size());
+        size_t polygons = 0, levelPolygons = 0, pathEntries = 0;
+        for(auto node = polymap.begin(); node != polymap.end(); ++node) polygons += node->second.size();
+        for(auto level = map.begin(); level != map.end(); ++level) levelPolygons += level->size();
+        for(auto entry = tables.begin(); entry != tables.end(); ++entry) pathEntries += entry->second.size();
+        MARK_HIGH(antPolygons, polygons);
+        MARK_HIGH(antLevelPolygons, levelPolygons);
+        MARK_HIGH(antPathEntries, pathEntries);
+    };
+    //the curve scores the polygon of every ant against the convex hull, like the other optimizers
+    ConvergenceCurve curve("ant colony", (mode==0) ? maximization : minimization);
+    double hullArea=0;
+    long ants=0;
+    if(curve.enabled()){
+        PointList hull;
+        CGAL::convex_hull_2(list.begin(), list.end(), std::back_inserter(hull));
+        hullArea=abs(Polygon_2(hull.begin(), hull.end()).area());
+    }
+    space= Generate3(test,cancellation);
+    if(space.empty()){
+        markContainers();
+        return BestForCircle; //out of time before a single triangle was found
+    }
     int AreaOfAllTriangles=0;
     //add every triangle to the graph
     //Every polygon has a number assosiated with it, that is stored in enumvals
@@ -473,9 +511,15 @@ Polygon_2 Ant::optimalPolygon(){
 
     ph=2;
     int elitism=argFlags.elitism;
+    bool stop=false; //set when we run out of time, only the ants that finished their path are kept
     
     for(int c=0;c<C;c++){
+        TraceSpan cycle("loop", "ant cycle", true);
         for(int k=0;k<K;k++){
+            if(cancelled()){
+                stop=true;
+                break;
+            }
             temp.clear();
             num.clear();
             adder.clear();
@@ -493,7 +537,7 @@ Polygon_2 Ant::optimalPolygon(){
 
                     prob=AreaOfAllTriangles/t1[0].area();
                     prob/=100;
-                    int var=rand()%2;
+                    int var=randomInt()%2;
 
                     if(var<prob)
                     {
@@ -504,7 +548,7 @@ Polygon_2 Ant::optimalPolygon(){
                 else{
                     prob=t1[0].area()/AreaOfAllTriangles;
                     prob/=100;
-                    int var=rand()%2;
+                    int var=randomInt()%2;
                     if(var<prob)
                     {
                         next=t1[0];
@@ -522,6 +566,10 @@ Polygon_2 Ant::optimalPolygon(){
             std::vector<Point> test1=test;
 
             for(int i=2;i<=test.size();i++){
+                if(cancelled()){
+                    stop=true;
+                    break;
+                }
 
                 //for every point left,generate a list of polygons, pick one ,generate a list of polygons ......
                 num.push_back(enumvals[convert(next)]);
@@ -534,7 +582,7 @@ Polygon_2 Ant::optimalPolygon(){
 
                 }else{
 
-                    temp= GenerateX(next,test1,argFlags.enable_breaks,argFlags.divisor);
+                    temp= GenerateX(next,test1,argFlags.enable_breaks,argFlags.divisor,cancellation);
                     polymap[enumvals[convert(next)]]=temp;
 
                 }
@@ -610,7 +658,7 @@ Polygon_2 Ant::optimalPolygon(){
                     std::list<table>::iterator it=tablebot.begin();
                     advance(it,t);
                     double prob=ProbFunction(argFlags.alpha,argFlags.beta,*it,tablebot);
-                    int var=rand()%2;
+                    int var=randomInt()%2;
                     if(var<prob)
                     {
                         next=t1[0];
@@ -625,6 +673,8 @@ Polygon_2 Ant::optimalPolygon(){
                 if(temp.size()!=0)
                     test1.erase(test1.begin()+Pointpoped[convert(next)]);
             }
+            if(stop)
+                break;
     
             paths[k]=num;
             num.clear();
@@ -653,6 +703,8 @@ Polygon_2 Ant::optimalPolygon(){
                     elitismk=k;
                 }
             }
+            if(curve.enabled() && hullArea>0)
+                curve.record(++ants, abs(next.area())/hullArea);
         }
         //Find the max or min that any ant has found in any circle
         if(mode==0){
@@ -671,6 +723,8 @@ Polygon_2 Ant::optimalPolygon(){
                 elitismpos=elitismk;
             }
         }
+        if(stop)
+            break;
         //If elisitm is 0 then the entire table of solution paths is given to updatetrails so every ant adds pheromone to its path
         if(elitism==0){
             for( int t=0;t<K;t++)
@@ -684,11 +738,13 @@ Polygon_2 Ant::optimalPolygon(){
         }
     }
 
+    markContainers();
+
     Polygon_2 poly;
 
     //Finally return the max or min polygon
     poly=BestForCircle;
-    std::ofstream os("test.wkt");
+    dumpPolygon(poly,"ant colony");
 
     return poly;
 
@@ -0,0 +1,20 @@
+#ifndef BENCH_ALGORITHM_SOURCES_H
+#define BENCH_ALGORITHM_SOURCES_H
+
+/*
+    The benchmarks are built like evaluate, with cgal_create_CMakeLists in their own directory, which only picks up the .cpp files found there.
+    So every benchmark compiles the algorithms of the parent directory into its single translation unit through this header.
+*/
+
+#include "../incr.cpp"
+#include "../ConvexHullAlgo.cpp"
+#include "../onion.cpp"
+#include "../local.cpp"
+#include "../SimulatedAnnealing.cpp"
+#include "../ant.cpp"
+#include "../Pick.cpp"
+#include "../PolygonDump.cpp"
+#include "../Trace.cpp"
+#include "../ConvergenceRecorder.cpp"
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef BENCH_RESULTS_H
+#define BENCH_RESULTS_H
+
+#include <string>
+#include <cstdio>
+#include <stdexcept>
+
+/*
+    Result file shared by the benchmarks (-o <file>), one line per sample of a benchmark:
+
+        # bench results 1
+        <benchmark name>\t<nanoseconds>\t<extra fields>
+
+    The nanoseconds are the measured time of the sample (per call for microbenchmarks), the tab separated
+    <key>=<value> extra fields describe it (score, throughput, cutoff ...) and are not compared.
+    A sample that produced no time is written with 0 nanoseconds and crashed=1 (the run failed) or skipped=1 (the run was
+    not attempted, e.g. a larger size after a cutoff), so the file tells these apart from benchmarks that were never asked for.
+*/
+
+static const char benchResultsHeader[] = "# bench results 1";
+
+class BenchResults
+{
+private:
+    FILE* output;
+
+public:
+    // no file is written for an empty <path>
+    BenchResults(std::string path): output(nullptr)
+    {
+        if(path.empty())
+            return;
+
+        output = fopen(path.c_str(), "w");
+        if(output == nullptr)
+            throw std::runtime_error("Could not create benchmark results file " + path);
+        fprintf(output, "%s\n", benchResultsHeader);
+    }
+
+    ~BenchResults(){if(output != nullptr) fclose(output);}
+
+    BenchResults(const BenchResults&) = delete;
+    BenchResults& operator=(const BenchResults&) = delete;
+
+    void record(const std::string& name, double nanoseconds, const std::string& extras)
+    {
+        if(output == nullptr)
+            return;
+
+        fprintf(output, "%s\t%.0f%s%s\n", name.c_str(), nanoseconds, extras.empty() ? "" : "\t", extras.c_str());
+        fflush(output);
+    }
+};
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef SYNTHETIC_POINTS_H
+#define SYNTHETIC_POINTS_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <random>
+#include <algorithm>
+#include <unordered_set>
+#include <stdexcept>
+#include <cmath>
+#include <cstdint>
+
+/*
+    Families of point sets for the benchmarks, generated from a fixed seed so every run measures the same instances.
+    Points have distinct integer coordinates, like the instances evaluate reads.
+
+        uniform     uniform in a square
+        clustered   Gaussian clusters of about 100 points around uniform centers
+        grid        the first n nodes of a square grid in row order, full of collinear points, in shuffled order
+        star        uniform inside a five pointed star
+        circle      on a circle, rounded to the integer grid, so almost every point is on the convex hull
+        annulus     uniform in a ring between 70% and 100% of the radius
+        collinear   along a line, each point at most 1 unit off it
+*/
+
+struct IntPoint
+{
+    long long x;
+    long long y;
+};
+
+typedef std::vector<IntPoint> IntPointList;
+
+static const char* const syntheticFamilies[] = {"uniform", "clustered", "grid", "star", "circle", "annulus", "collinear"};
+
+// whether syntheticPoints knows <family>, so a tool can reject a name before it writes anything
+inline bool isSyntheticFamily(const std::string& family)
+{
+    for(const char* known : syntheticFamilies)
+        if(family == known) return true;
+    return false;
+}
+
+// the items of a comma separated flag value such as -families uniform,grid or -sizes 10,100, empty items are dropped
+inline std::vector<std::string> splitList(const char* list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while(std::getline(stream, item, ','))
+        if(!item.empty()) items.push_back(item);
+    return items;
+}
+
+// the side of the square the points of an <n> point set are spread over
+inline long long syntheticSide(int n)
+{
+    return std::max(100LL, 8 * (long long) std::ceil(std::sqrt((double) n)));
+}
+
+// adds (x, y) to <points> unless it is already there
+inline void addDistinct(IntPointList& points, std::unordered_set<uint64_t>& seen, long long x, long long y)
+{
+    uint64_t key = ((uint64_t) (uint32_t) (int32_t) x << 32) | (uint32_t) (int32_t) y;
+    if(seen.insert(key).second)
+        points.push_back({x, y});
+}
+
+inline IntPointList syntheticPoints(const std::string& family, int n, unsigned long seed)
+{
+    std::mt19937_64 generator(seed ^ (std::hash<std::string>()(family) + (uint64_t) n * 0x9e3779b97f4a7c15ULL));
+    long long side = syntheticSide(n);
+
+    IntPointList points;
+    std::unordered_set<uint64_t> seen;
+    points.reserve(n);
+
+    if(family == "uniform")
+    {
+        std::uniform_int_distribution<long long> coordinate(0, side - 1);
+        while((int) points.size() < n)
+            addDistinct(points, seen, coordinate(generator), coordinate(generator));
+    }
+    else if(family == "clustered")
+    {
+        int clusters = std::max(1, n / 100);
+        double spread = side / (4.0 * std::sqrt((double) clusters));
+
+        std::uniform_real_distribution<double> center(spread, side - spread);
+        std::vector<std::pair<double, double>> centers;
+        for(int i = 0; i < clusters; i++)
+            centers.push_back(std::make_pair(center(generator), center(generator)));
+
+        std::normal_distribution<double> offset(0, spread);
+        std::uniform_int_distribution<int> pick(0, clusters - 1);
+        while((int) points.size() < n)
+        {
+            const std::pair<double, double>& c = centers[pick(generator)];
+            addDistinct(points, seen, std::llround(c.first + offset(generator)), std::llround(c.second + offset(generator)));
+        }
+    }
+    else if(family == "grid")
+    {
+        long long columns = (long long) std::ceil(std::sqrt((double) n));
+        for(int i = 0; i < n; i++)
+            points.push_back({(i % columns) * 8, (i / columns) * 8});
+
+        std::shuffle(points.begin(), points.end(), generator);
+    }
+    else if(family == "star")
+    {
+        double radius = side / 2.0;
+        std::uniform_real_distribution<double> unit(0, 1);
+        while((int) points.size() < n)
+        {
+            double angle = 2 * M_PI * unit(generator);
+            double limit = radius * (0.35 + 0.65 * std::pow(std::fabs(std::cos(2.5 * angle)), 3));
+            double r = limit * std::sqrt(unit(generator));
+            addDistinct(points, seen, std::llround(radius + r * std::cos(angle)), std::llround(radius + r * std::sin(angle)));
+        }
+    }
+    else if(family == "circle" || family == "annulus")
+    {
+        //the circle needs a circumference of several units per point, or rounding leaves too few distinct points on it
+        double radius = (family == "circle") ? std::max(side / 2.0, 2.0 * n) : side / 2.0;
+        double inner = (family == "circle") ? radius : 0.7 * radius;
+
+        std::uniform_real_distribution<double> unit(0, 1);
+        while((int) points.size() < n)
+        {
+            double angle = 2 * M_PI * unit(generator);
+            double r = std::sqrt(inner * inner + (radius * radius - inner * inner) * unit(generator));
+            addDistinct(points, seen, std::llround(radius + r * std::cos(angle)), std::llround(radius + r * std::sin(angle)));
+        }
+    }
+    else if(family == "collinear")
+    {
+        //distinct x values, so the points never pile up on each other
+        long long length = std::max((long long) n * 4, side);
+        std::uniform_int_distribution<long long> coordinate(0, length - 1);
+        std::uniform_int_distribution<int> jitter(-1, 1);
+        while((int) points.size() < n)
+        {
+            long long x = coordinate(generator);
+            if(seen.insert(x).second)
+                points.push_back({x, x / 2 + jitter(generator)});
+        }
+    }
+    else
+        throw std::runtime_error("Unknown point set family " + family);
+
+    return points;
+}
+
+// twice the area of the convex hull of <points>, exact since the coordinates are integers (monotone chain)
+inline long long twiceHullArea(IntPointList points)
+{
+    std::sort(points.begin(), points.end(), [](const IntPoint& a, const IntPoint& b){return a.x < b.x || (a.x == b.x && a.y < b.y);});
+    if(points.size() < 3)
+        return 0;
+
+    auto cross = [](const IntPoint& o, const IntPoint& a, const IntPoint& b){return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);};
+
+    IntPointList hull(2 * points.size());
+    size_t k = 0;
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        while(k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) k--;
+        hull[k++] = points[i];
+    }
+    for(size_t i = points.size() - 1, lower = k + 1; i > 0; i--)
+    {
+        while(k >= lower && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0) k--;
+        hull[k++] = points[i - 1];
+    }
+    hull.resize(k - 1);
+
+    long long twiceArea = 0;
+    for(size_t i = 0; i < hull.size(); i++)
+    {
+        const IntPoint& a = hull[i];
+        const IntPoint& b = hull[(i + 1) % hull.size()];
+        twiceArea += a.x * b.y - a.y * b.x;
+    }
+    return std::llabs(twiceArea);
+}
+
+#endif
@@ -0,0 +1,298 @@
+#include "../BenchResults.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/*
+    bench_compare compares two result files of the benchmarks (BenchResults.h), a baseline and a candidate, benchmark by benchmark.
+    The samples of a benchmark are summarized by their median and their median absolute deviation (MAD), and a benchmark
+
+        regressed   if its candidate median is more than -threshold percent (default 10) above the baseline median
+                    and the difference is more than -noise (default 3) times the combined MAD of the two sides
+        improved    the same, below the baseline
+        same        otherwise
+
+    so a single noisy sample does not fail the comparison when the benchmarks were run with -repeat.
+    A benchmark that stopped producing times fails the comparison too, since a path that starts crashing or running out of
+    its budget is the worst regression of all:
+
+        missing     in the baseline but not in the candidate
+        crashed     a candidate sample crashed (crashed=1) and no baseline sample did
+        skipped     the candidate has only skipped samples (skipped=1) and the baseline has times
+        cutoff      a candidate sample was cut off by the budget (cutoff=1) and no baseline sample was, so its time
+                    is the budget rather than a measurement. -allowCutoffs compares such samples as plain times
+
+    Benchmarks found only in the candidate are listed as new.
+    The exit code is 1 if any benchmark regressed or failed, so the comparison can run as a check before merging:
+
+    ./bench_compare <baseline file> <candidate file> [-threshold percent] [-noise k] [-only <text>] [-allowCutoffs]
+*/
+
+struct CompareSettings
+{
+    std::string baselineFile;
+    std::string candidateFile;
+    double threshold;   // percent
+    double noise;       // multiple of the combined MAD a difference must exceed
+    std::string only;   // compare only the benchmarks whose name contains it
+    bool allowCutoffs;  // compare cut off candidate samples as plain times
+};
+
+struct SampleSummary
+{
+    int samples;
+    double median;
+    double mad;
+};
+
+// the samples of one benchmark in a result file
+struct BenchEntry
+{
+    std::vector<double> times;  // nanoseconds of the samples that have a time
+    int crashed = 0;
+    int skipped = 0;
+    int cutoffs = 0;
+};
+
+// the samples of every benchmark of a result file, in the order the benchmarks first appear
+typedef std::vector<std::pair<std::string, BenchEntry>> BenchSamples;
+
+// whether the tab separated extra fields starting at <extras> hold <field>
+bool hasExtra(const char* extras, const char* field)
+{
+    size_t length = strlen(field);
+    for(const char* at = extras; at != nullptr && *at != '\0'; at = strchr(at, '\t'))
+    {
+        if(*at == '\t') at++;
+        if(!strncmp(at, field, length) && (at[length] == '\t' || at[length] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+BenchSamples readBenchResults(const std::string& path)
+{
+    std::ifstream input(path);
+    if(!input)
+        throw std::runtime_error("Could not open " + path);
+
+    std::string line;
+    if(!std::getline(input, line) || line != benchResultsHeader)
+        throw std::runtime_error(path + " is not a benchmark results file");
+
+    BenchSamples benchmarks;
+    std::map<std::string, size_t> positions;
+    int lineNumber = 1;
+
+    while(std::getline(input, line))
+    {
+        lineNumber++;
+        if(line.empty() || line[0] == '#') continue;
+
+        size_t tab = line.find('\t');
+        if(tab == std::string::npos)
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": expected <name>\\t<nanoseconds>");
+
+        std::string name = line.substr(0, tab);
+        char* end;
+        double nanoseconds = strtod(line.c_str() + tab + 1, &end);
+        if(end == line.c_str() + tab + 1 || (*end != '\t' && *end != '\0'))
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": expected <name>\\t<nanoseconds>");
+
+        auto position = positions.find(name);
+        if(position == positions.end())
+        {
+            positions[name] = benchmarks.size();
+            benchmarks.push_back(std::make_pair(name, BenchEntry()));
+            position = positions.find(name);
+        }
+
+        BenchEntry& entry = benchmarks[position->second].second;
+        if(hasExtra(end, "crashed=1"))
+            entry.crashed++;
+        else if(hasExtra(end, "skipped=1"))
+            entry.skipped++;
+        else
+        {
+            entry.times.push_back(nanoseconds);
+            if(hasExtra(end, "cutoff=1")) entry.cutoffs++;
+        }
+    }
+
+    return benchmarks;
+}
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return (values.size() % 2) ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+SampleSummary summarize(const std::vector<double>& samples)
+{
+    SampleSummary summary;
+    summary.samples = samples.size();
+    summary.median = median(samples);
+
+    std::vector<double> deviations;
+    for(double sample : samples)
+        deviations.push_back(fabs(sample - summary.median));
+    summary.mad = median(deviations);
+
+    return summary;
+}
+
+// the median and MAD columns of a benchmark, dashes when it has no times
+std::string summaryColumns(const BenchEntry* entry)
+{
+    char columns[64];
+    if(entry == nullptr || entry->times.empty())
+        snprintf(columns, sizeof(columns), "%14s %10s", "-", "-");
+    else
+    {
+        SampleSummary summary = summarize(entry->times);
+        snprintf(columns, sizeof(columns), "%14.0f %10.0f", summary.median, summary.mad);
+    }
+    return columns;
+}
+
+bool parseArgs(CompareSettings& settings, int argc, char** argv)
+{
+    settings.threshold = 10;
+    settings.noise = 3;
+    settings.allowCutoffs = false;
+
+    std::vector<std::string> files;
+    for(int i = 1; i < argc; i++)
+    {
+        if(argv[i][0] != '-')
+        {
+            files.push_back(argv[i]);
+            continue;
+        }
+
+        if(!strcmp(argv[i], "-allowCutoffs"))
+        {
+            settings.allowCutoffs = true;
+            continue;
+        }
+
+        if(i + 1 >= argc)
+            return false;
+
+        const char* value = argv[++i];
+        if(!strcmp(argv[i - 1], "-threshold"))
+            settings.threshold = atof(value);
+        else if(!strcmp(argv[i - 1], "-noise"))
+            settings.noise = atof(value);
+        else if(!strcmp(argv[i - 1], "-only"))
+            settings.only = value;
+        else
+            return false;
+    }
+
+    if(files.size() != 2 || settings.threshold < 0 || settings.noise < 0)
+        return false;
+
+    settings.baselineFile = files[0];
+    settings.candidateFile = files[1];
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    CompareSettings settings;
+    if(!parseArgs(settings, argc, argv))
+    {
+        std::cout << "./bench_compare <baseline file> <candidate file> [-threshold percent] [-noise k] [-only <text>] [-allowCutoffs]" << std::endl;
+        return -1;
+    }
+
+    BenchSamples baseline, candidate;
+    try
+    {
+        baseline = readBenchResults(settings.baselineFile);
+        candidate = readBenchResults(settings.candidateFile);
+    }
+    catch(const std::exception& error)
+    {
+        std::cout << error.what() << std::endl;
+        return -1;
+    }
+
+    std::map<std::string, const BenchEntry*> candidateSamples;
+    for(auto& benchmark : candidate)
+        candidateSamples[benchmark.first] = &benchmark.second;
+
+    int regressed = 0, improved = 0, compared = 0, failed = 0;
+    printf("%-48s %14s %10s %14s %10s %9s\n", "benchmark", "baseline ns", "MAD", "candidate ns", "MAD", "delta");
+
+    for(auto& benchmark : baseline)
+    {
+        const std::string& name = benchmark.first;
+        const BenchEntry& base = benchmark.second;
+        if(name.find(settings.only) == std::string::npos) continue;
+
+        auto found = candidateSamples.find(name);
+        const BenchEntry* next = (found != candidateSamples.end()) ? found->second : nullptr;
+        if(found != candidateSamples.end()) candidateSamples.erase(found);
+
+        //a benchmark that stopped producing times fails, whatever its other samples measured
+        const char* failure = nullptr;
+        if(next == nullptr)
+            failure = "missing";
+        else if(next->crashed > 0 && base.crashed == 0)
+            failure = "crashed";
+        else if(next->times.empty() && !base.times.empty())
+            failure = "skipped";
+        else if(next->cutoffs > 0 && base.cutoffs == 0 && !settings.allowCutoffs)
+            failure = "cutoff";
+
+        std::string baseColumns = summaryColumns(&base), nextColumns = summaryColumns(next);
+
+        if(failure != nullptr)
+        {
+            printf("%-48s %s %s %9s  %s\n", name.c_str(), baseColumns.c_str(), nextColumns.c_str(), "-", failure);
+            failed++;
+            continue;
+        }
+
+        //nothing to compare when either side has no time, e.g. a cell skipped in both files
+        if(base.times.empty() || next->times.empty())
+        {
+            printf("%-48s %s %s %9s  %s\n", name.c_str(), baseColumns.c_str(), nextColumns.c_str(), "-", base.times.empty() ? "no baseline" : "skipped");
+            continue;
+        }
+
+        SampleSummary before = summarize(base.times);
+        SampleSummary after = summarize(next->times);
+        compared++;
+
+        double difference = after.median - before.median;
+        double delta = (before.median > 0) ? 100 * difference / before.median : 0;
+        bool significant = fabs(delta) > settings.threshold && fabs(difference) > settings.noise * (before.mad + after.mad);
+
+        const char* status = "same";
+        if(significant && difference > 0) {status = "regressed"; regressed++;}
+        else if(significant) {status = "improved"; improved++;}
+
+        printf("%-48s %14.0f %10.0f %14.0f %10.0f %+8.1f%%  %s\n", name.c_str(), before.median, before.mad, after.median, after.mad, delta, status);
+    }
+
+    for(auto& benchmark : candidate)
+    {
+        if(benchmark.first.find(settings.only) == std::string::npos || !candidateSamples.count(benchmark.first)) continue;
+
+        printf("%-48s %14s %10s %s %9s  new\n", benchmark.first.c_str(), "-", "-", summaryColumns(&benchmark.second).c_str(), "-");
+    }
+
+    printf("\n%d compared, %d regressed, %d improved, %d failed (threshold %.1f%%, noise %.1f MAD)\n", compared, regressed, improved, failed,
+        settings.threshold, settings.noise);
+    return (regressed || failed) ? 1 : 0;
+}
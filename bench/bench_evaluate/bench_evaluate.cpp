@@ -0,0 +1,360 @@
+#include "../AlgorithmSources.h"
+#include "../SyntheticPoints.h"
+#include "../BenchResults.h"
+#include "../../CancellationToken.h"
+#include "../../RandomSource.h"
+
+#include <iostream>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+/*
+    bench_evaluate runs every generator and every optimizer on the synthetic point set families of SyntheticPoints.h,
+    from 10 to 100k points, and reports time, score and throughput (points per second) for each (family, size, algorithm) cell.
+    Optimizers start from the polygon of IncAlgo (a1, random edges) for the same point set, generated outside the measurement.
+    A cell that runs past its budget is reported as a cutoff and the larger sizes of the same algorithm and family are skipped.
+    Every sample runs in a child process, so an algorithm that crashes on a degenerate family is reported as crashed and the suite goes on.
+
+    ./bench_evaluate [-families uniform,clustered,grid,star] [-sizes 10,100,1000,10000,100000] [-repeat R] [-seed S] [-budget ms]
+                     [-only <text>] [-o <results file>]
+*/
+
+struct BenchSettings
+{
+    std::vector<std::string> families;
+    std::vector<int> sizes;
+    int repeat;
+    unsigned long seed;
+    long budget;                // milliseconds per sample
+    std::string only;           // run only the algorithms whose name contains it
+    std::string outputFile;
+};
+
+struct Sample
+{
+    double milliseconds;
+    double score;
+    bool cutoff;
+    bool crashed;
+};
+
+typedef std::function<PolygonGenerator*(PointList&)> GeneratorFactory;
+typedef std::function<PolygonOptimizer*(Polygon_2&, PointList&, long, OptimizationType)> OptimizerFactory;
+
+std::vector<std::pair<std::string, GeneratorFactory>> benchGenerators()
+{
+    std::vector<std::pair<std::string, GeneratorFactory>> generators;
+    const char* initializations[] = {"a1", "a2", "b1", "b2"};
+    const char* selections[] = {"random", "min", "max"};
+
+    for(int i = 0; i < 4; i++)
+        for(int e = 0; e < 3; e++)
+            generators.push_back(std::make_pair(std::string("IncAlgo-") + initializations[i] + "-" + selections[e],
+                [i, e](PointList& points){return (PolygonGenerator*) new IncAlgo(points, (Initialization) i, (EdgeSelection) e);}));
+
+    for(int e = 0; e < 3; e++)
+        generators.push_back(std::make_pair(std::string("ConvexHullAlgo-") + selections[e],
+            [e](PointList& points){return (PolygonGenerator*) new ConvexHullAlgo(points, (EdgeSelection) e);}));
+
+    for(int option = 1; option <= 4; option++)
+        generators.push_back(std::make_pair("OnionAlgo-" + std::to_string(option),
+            [option](PointList& points){return (PolygonGenerator*) new OnionAlgo(points, option);}));
+
+    return generators;
+}
+
+// the optimizers with the parameters of DefaultHandler
+std::vector<std::pair<std::string, OptimizerFactory>> benchOptimizers()
+{
+    std::vector<std::pair<std::string, OptimizerFactory>> optimizers;
+
+    optimizers.push_back(std::make_pair("LocalAlgo", [](Polygon_2& initial, PointList&, long hullArea, OptimizationType type){
+        return (PolygonOptimizer*) new LocalAlgo(initial, hullArea, 0.10, type, 1);}));
+    optimizers.push_back(std::make_pair("Annealing-local", [](Polygon_2& initial, PointList&, long hullArea, OptimizationType type){
+        return (PolygonOptimizer*) new SimulatedAnnealing(initial, hullArea, 2500, type, AnnealingType::local);}));
+    optimizers.push_back(std::make_pair("Annealing-global", [](Polygon_2& initial, PointList&, long hullArea, OptimizationType type){
+        return (PolygonOptimizer*) new SimulatedAnnealing(initial, hullArea, 2500, type, AnnealingType::global);}));
+    optimizers.push_back(std::make_pair("Ant", [](Polygon_2& initial, PointList& points, long, OptimizationType type){
+        AntParameters parameters;
+        parameters.alpha = 1;
+        parameters.elitism = 0;
+        parameters.beta = 3;
+        parameters.L = 2;
+        parameters.optimizationType = type;
+        parameters.ro = 0.05;
+        parameters.enable_breaks = 0;
+        parameters.divisor = 2;
+        return (PolygonOptimizer*) new Ant(parameters, points, initial);}));
+
+    return optimizers;
+}
+
+// reads exactly <size> bytes, false if the writer went away first
+bool readAll(int fd, void* data, size_t size)
+{
+    char* cur = (char*) data;
+    while(size > 0)
+    {
+        ssize_t got = read(fd, cur, size);
+        if(got <= 0) return false;
+        cur += got;
+        size -= got;
+    }
+    return true;
+}
+
+void writeAll(int fd, const void* data, size_t size)
+{
+    const char* cur = (const char*) data;
+    while(size > 0)
+    {
+        ssize_t put = write(fd, cur, size);
+        if(put <= 0) return;
+        cur += put;
+        size -= put;
+    }
+}
+
+/*
+    Times <run> under a fresh budget in a child process, the score being the area of the polygon it returns over <hullArea>.
+    The polygon is handed back in <polygon> if it is not null.
+*/
+Sample measure(std::function<Polygon_2(const CancellationToken*)> run, long budget, double hullArea, unsigned long seed, Polygon_2* polygon = nullptr)
+{
+    Sample sample = {0, 0, false, true};
+    int channel[2];
+    if(pipe(channel) != 0)
+        throw std::runtime_error("Could not create a pipe");
+
+    fflush(stdout);
+    pid_t child = fork();
+    if(child < 0)
+        throw std::runtime_error("Could not fork");
+
+    if(child == 0)
+    {
+        close(channel[0]);
+
+        CancellationToken token;
+        token.setBudget(std::chrono::milliseconds(budget));
+        seedRandom(seed);
+
+        auto start = std::chrono::steady_clock::now();
+        Polygon_2 result = run(&token);
+        auto stop = std::chrono::steady_clock::now();
+
+        sample.milliseconds = std::chrono::duration<double, std::milli>(stop - start).count();
+        sample.cutoff = token.expired() || sample.milliseconds >= budget;
+        sample.score = (hullArea > 0) ? std::abs(CGAL::to_double(result.area())) / hullArea : 0;
+        sample.crashed = false;
+        writeAll(channel[1], &sample, sizeof(sample));
+
+        long vertices = result.size();
+        writeAll(channel[1], &vertices, sizeof(vertices));
+        for(auto it = result.vertices_begin(); it != result.vertices_end(); ++it)
+        {
+            double coordinates[2] = {CGAL::to_double(it->x()), CGAL::to_double(it->y())};
+            writeAll(channel[1], coordinates, sizeof(coordinates));
+        }
+
+        fflush(stdout);
+        _exit(0);
+    }
+
+    close(channel[1]);
+
+    long vertices = 0;
+    Sample received;
+    if(readAll(channel[0], &received, sizeof(received)) && readAll(channel[0], &vertices, sizeof(vertices)))
+    {
+        sample = received;
+        if(polygon != nullptr) polygon->clear();
+
+        double coordinates[2];
+        for(long i = 0; i < vertices && readAll(channel[0], coordinates, sizeof(coordinates)); i++)
+            if(polygon != nullptr) polygon->push_back(Point_2(coordinates[0], coordinates[1]));
+    }
+
+    close(channel[0]);
+
+    int status;
+    waitpid(child, &status, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        sample.crashed = true;
+
+    return sample;
+}
+
+std::string benchName(const std::string& family, int size, const std::string& algorithm)
+{
+    return "evaluate/" + family + "/" + std::to_string(size) + "/" + algorithm;
+}
+
+void report(BenchResults& results, const std::string& family, int size, const std::string& algorithm, std::vector<Sample>& samples)
+{
+    std::string name = benchName(family, size, algorithm);
+    bool cutoff = false;
+
+    //a crashed sample has no time to compare, it is recorded without one so the results show the crash
+    for(const Sample& sample : samples)
+        if(sample.crashed) results.record(name, 0, "crashed=1");
+    samples.erase(std::remove_if(samples.begin(), samples.end(), [](const Sample& sample){return sample.crashed;}), samples.end());
+    if(samples.empty())
+    {
+        printf("%-10s %8d  %-24s %12s %10s %14s  crashed\n", family.c_str(), size, algorithm.c_str(), "-", "-", "-");
+        return;
+    }
+
+    for(size_t i = 0; i < samples.size(); i++)
+    {
+        char extras[128];
+        snprintf(extras, sizeof(extras), "score=%.6f\tpoints_per_s=%.0f\tcutoff=%d", samples[i].score, size / (samples[i].milliseconds / 1000), (int) samples[i].cutoff);
+        results.record(name, samples[i].milliseconds * 1e6, extras);
+        cutoff = cutoff || samples[i].cutoff;
+    }
+
+    std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b){return a.milliseconds < b.milliseconds;});
+    const Sample& median = samples[samples.size() / 2];
+
+    printf("%-10s %8d  %-24s %12.3f %10.4f %14.0f  %s\n", family.c_str(), size, algorithm.c_str(), median.milliseconds, median.score,
+        size / (median.milliseconds / 1000), cutoff ? "cutoff" : "");
+    fflush(stdout);
+}
+
+// a cell that is not run is recorded without a time, so the results tell it apart from a cell left out by -only
+void skipped(BenchResults& results, const std::string& family, int size, const std::string& algorithm)
+{
+    results.record(benchName(family, size, algorithm), 0, "skipped=1");
+    printf("%-10s %8d  %-24s %12s %10s %14s  skipped\n", family.c_str(), size, algorithm.c_str(), "-", "-", "-");
+}
+
+bool parseArgs(BenchSettings& settings, int argc, char** argv)
+{
+    settings.families = {"uniform", "clustered", "grid", "star"};
+    settings.sizes = {10, 100, 1000, 10000, 100000};
+    settings.repeat = 1;
+    settings.seed = 1;
+    settings.budget = 10000;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(i + 1 >= argc)
+            return false;
+
+        const char* value = argv[++i];
+        if(!strcmp(argv[i - 1], "-families"))
+            settings.families = splitList(value);
+        else if(!strcmp(argv[i - 1], "-sizes"))
+        {
+            settings.sizes.clear();
+            for(const std::string& size : splitList(value))
+                settings.sizes.push_back(atoi(size.c_str()));
+        }
+        else if(!strcmp(argv[i - 1], "-repeat"))
+            settings.repeat = atoi(value);
+        else if(!strcmp(argv[i - 1], "-seed"))
+            settings.seed = strtoul(value, nullptr, 10);
+        else if(!strcmp(argv[i - 1], "-budget"))
+            settings.budget = atol(value);
+        else if(!strcmp(argv[i - 1], "-only"))
+            settings.only = value;
+        else if(!strcmp(argv[i - 1], "-o"))
+            settings.outputFile = value;
+        else
+            return false;
+    }
+
+    std::sort(settings.sizes.begin(), settings.sizes.end());
+    return settings.repeat > 0 && settings.budget > 0 && !settings.sizes.empty() && settings.sizes[0] >= 3;
+}
+
+int main(int argc, char** argv)
+{
+    BenchSettings settings;
+    if(!parseArgs(settings, argc, argv))
+    {
+        std::cout << "./bench_evaluate [-families uniform,clustered,grid,star] [-sizes 10,100,1000,10000,100000] [-repeat R] [-seed S] "
+            "[-budget ms] [-only <text>] [-o <results file>]" << std::endl;
+        return -1;
+    }
+
+    BenchResults results(settings.outputFile);
+    auto generators = benchGenerators();
+    auto optimizers = benchOptimizers();
+
+    printf("%-10s %8s  %-24s %12s %10s %14s\n", "family", "size", "algorithm", "ms", "score", "points/s");
+
+    for(const std::string& family : settings.families)
+    {
+        //an algorithm that ran out of budget on a size is not tried on the larger ones
+        std::set<std::string> exhausted;
+
+        for(int size : settings.sizes)
+        {
+            IntPointList synthetic = syntheticPoints(family, size, settings.seed);
+            double hullArea = twiceHullArea(synthetic) / 2.0;
+
+            PointList points;
+            for(const IntPoint& point : synthetic)
+                points.push_back(Point_2(point.x, point.y));
+
+            for(auto& generator : generators)
+            {
+                if(generator.first.find(settings.only) == std::string::npos) continue;
+                if(exhausted.count(generator.first)) {skipped(results, family, size, generator.first); continue;}
+
+                std::vector<Sample> samples;
+                for(int r = 0; r < settings.repeat; r++)
+                {
+                    samples.push_back(measure([&](const CancellationToken* token){
+                        std::unique_ptr<PolygonGenerator> algorithm(generator.second(points));
+                        algorithm->setCancellation(token);
+                        return algorithm->generatePolygon();
+                    }, settings.budget, hullArea, settings.seed + r));
+                }
+
+                if(samples[0].cutoff && !samples[0].crashed) exhausted.insert(generator.first);
+                report(results, family, size, generator.first, samples);
+            }
+
+            //the common starting polygon of the optimizers
+            Polygon_2 initial;
+            Sample start = measure([&](const CancellationToken* token){
+                IncAlgo algorithm(points, Initialization::a1, EdgeSelection::randomSelection);
+                algorithm.setCancellation(token);
+                return algorithm.generatePolygon();
+            }, settings.budget, hullArea, settings.seed, &initial);
+
+            for(auto& optimizer : optimizers)
+            {
+                for(OptimizationType type : {minimization, maximization})
+                {
+                    std::string name = optimizer.first + ((type == minimization) ? "-min" : "-max");
+                    if(name.find(settings.only) == std::string::npos) continue;
+                    if(start.cutoff || start.crashed || exhausted.count(name)) {skipped(results, family, size, name); continue;}
+
+                    std::vector<Sample> samples;
+                    for(int r = 0; r < settings.repeat; r++)
+                    {
+                        samples.push_back(measure([&](const CancellationToken* token){
+                            Polygon_2 polygon = initial;
+                            std::unique_ptr<PolygonOptimizer> algorithm(optimizer.second(polygon, points, (long) hullArea, type));
+                            algorithm->setCancellation(token);
+                            return algorithm->optimalPolygon();
+                        }, settings.budget, hullArea, settings.seed + r));
+                    }
+
+                    if(samples[0].cutoff && !samples[0].crashed) exhausted.insert(name);
+                    report(results, family, size, name, samples);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
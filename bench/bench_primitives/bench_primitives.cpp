@@ -0,0 +1,351 @@
+#include "../AlgorithmSources.h"
+#include "../SyntheticPoints.h"
+#include "../BenchResults.h"
+
+#include <iostream>
+#include <functional>
+#include <chrono>
+#include <cstring>
+
+/*
+    bench_primitives times the geometric primitives the algorithms spend their time in, each on its own, against the size of the polygon:
+
+        isReplaceable                               ConvexHullAlgo.cpp
+        isVisible, getClosestK, pointInPolygon      onion.cpp
+        applyChanges, findEdgeInPoly                local.cpp
+        validityLocal, validityGlobal               SimulatedAnnealing.cpp
+        Pick                                        Pick.cpp
+
+    The inputs are fixed: for every size the polygon is the star shaped polygon of a uniform point set (SyntheticPoints.h) sorted by angle
+    around its center and the queries (points, edges, vertex chains) are drawn from a generator with a fixed seed, then cycled through.
+    Every primitive is called in batches that double until a batch lasts -min-time, the time per call of the last batch being one sample.
+    The median of the samples is reported in ns/call, along with the slope of log(ns/call) over log(size), fitted on all the sizes measured,
+    which is the exponent of the growth of the primitive (1 for linear).
+    A primitive whose single call lasts longer than -max-call is not tried on the larger sizes.
+
+    ./bench_primitives [-sizes 64,256,1024,4096,16384] [-repeat R] [-min-time ms] [-max-call ms] [-only <text>] [-o <results file>]
+*/
+
+struct PrimitiveSettings
+{
+    std::vector<int> sizes;
+    int repeat;
+    double minTime;         // milliseconds per batch
+    double maxCall;         // milliseconds per call above which the larger sizes are skipped
+    std::string only;       // run only the primitives whose name contains it
+    std::string outputFile;
+};
+
+static const int queryCount = 1024;    // distinct inputs cycled through by every primitive
+static const unsigned long primitiveSeed = 1;
+
+// the fixed inputs of one size
+struct PrimitiveInputs
+{
+    Polygon_2 polygon;
+    long hullArea;
+    PointList queries;          // points of another point set of the same size, inside and outside the polygon
+    std::vector<int> vertices;  // vertex indices, away from the ends of the vertex list
+    std::vector<int> others;    // vertex indices, at least 2 positions away from the matching entry of <vertices>
+};
+
+// the vertices of <points> in angular order around their center, a star shaped polygon
+Polygon_2 starPolygon(const IntPointList& points)
+{
+    double cx = 0, cy = 0;
+    for(const IntPoint& point : points)
+    {
+        cx += point.x;
+        cy += point.y;
+    }
+    cx /= points.size();
+    cy /= points.size();
+
+    IntPointList sorted = points;
+    std::sort(sorted.begin(), sorted.end(), [cx, cy](const IntPoint& a, const IntPoint& b){
+        double angleA = atan2(a.y - cy, a.x - cx), angleB = atan2(b.y - cy, b.x - cx);
+        if(angleA != angleB) return angleA < angleB;
+        return (a.x - cx) * (a.x - cx) + (a.y - cy) * (a.y - cy) < (b.x - cx) * (b.x - cx) + (b.y - cy) * (b.y - cy);
+    });
+
+    Polygon_2 polygon;
+    for(const IntPoint& point : sorted)
+        polygon.push_back(Point_2(point.x, point.y));
+    return polygon;
+}
+
+PrimitiveInputs primitiveInputs(int size)
+{
+    PrimitiveInputs inputs;
+    IntPointList points = syntheticPoints("uniform", size, primitiveSeed);
+    inputs.polygon = starPolygon(points);
+    inputs.hullArea = twiceHullArea(points) / 2;
+
+    for(const IntPoint& point : syntheticPoints("uniform", size, primitiveSeed + 1))
+        inputs.queries.push_back(Point_2(point.x, point.y));
+
+    std::mt19937 generator(primitiveSeed);
+    while((int) inputs.queries.size() < queryCount)
+        inputs.queries.push_back(inputs.queries[generator() % size]);
+    inputs.queries.resize(queryCount);
+
+    for(int i = 0; i < queryCount; i++)
+    {
+        int vertex = 1 + generator() % (size - 2);
+        int other;
+        do{other = generator() % size;}while(abs(other - vertex) < 2 || abs(other - vertex) > size - 2);
+
+        inputs.vertices.push_back(vertex);
+        inputs.others.push_back(other);
+    }
+
+    return inputs;
+}
+
+// a benchmarked primitive, <prepare> returns the function making call number i for the inputs of one size
+struct Primitive
+{
+    std::string name;
+    std::function<std::function<void(int)>(PrimitiveInputs&)> prepare;
+};
+
+// keeps the results of the calls alive, so they are not optimized away
+volatile double primitiveSink;
+
+std::vector<Primitive> benchPrimitives()
+{
+    std::vector<Primitive> primitives;
+
+    primitives.push_back({"isReplaceable", [](PrimitiveInputs& inputs){
+        return std::function<void(int)>([&inputs](int i){
+            Polygon_2& polygon = inputs.polygon;
+            primitiveSink = isReplaceable(inputs.queries[i], polygon.edge(inputs.vertices[i]), polygon);
+        });
+    }});
+
+    primitives.push_back({"isVisible", [](PrimitiveInputs& inputs){
+        auto segments = std::make_shared<std::vector<Segment_2>>();
+        for(int i = 0; i < queryCount; i++)
+            segments->push_back(Segment_2(inputs.queries[i], inputs.polygon.vertex(inputs.vertices[i])));
+
+        return std::function<void(int)>([&inputs, segments](int i){
+            primitiveSink = isVisible((*segments)[i], inputs.polygon);
+        });
+    }});
+
+    primitives.push_back({"getClosestK", [](PrimitiveInputs& inputs){
+        return std::function<void(int)>([&inputs](int i){
+            int index;
+            getClosestK(inputs.queries[i], index, inputs.polygon);
+            primitiveSink = index;
+        });
+    }});
+
+    primitives.push_back({"pointInPolygon", [](PrimitiveInputs& inputs){
+        return std::function<void(int)>([&inputs](int i){
+            primitiveSink = pointInPolygon(inputs.queries[i], inputs.polygon);
+        });
+    }});
+
+    /*
+        applyChanges modifies the polygon, so call i moves vertex <vertices[i]> into the edge ending at <others[i]> and the next call moves it back,
+        through a 2 vertex polygon whose only edge ends at the vertex that followed it. The polygon is the same after every pair of calls.
+    */
+    primitives.push_back({"applyChanges", [](PrimitiveInputs& inputs){
+        auto polygon = std::make_shared<Polygon_2>(inputs.polygon);
+        auto returns = std::make_shared<std::vector<Polygon_2>>();
+        for(int i = 0; i < queryCount; i++)
+        {
+            Polygon_2 back;
+            back.push_back(inputs.polygon.vertex(inputs.vertices[i] - 1));
+            back.push_back(inputs.polygon.vertex(inputs.vertices[i] + 1));
+            returns->push_back(back);
+        }
+
+        return std::function<void(int)>([&inputs, polygon, returns](int i){
+            int move = i & ~1;
+            std::vector<Point_2> chain(1, inputs.polygon.vertex(inputs.vertices[move]));
+
+            if(i == move)
+            {
+                EdgeIterator edge = inputs.polygon.edges_begin() + (inputs.others[move] + inputs.polygon.size() - 1) % inputs.polygon.size();
+                applyChanges(*polygon, chain, edge);
+            }
+            else
+            {
+                EdgeIterator edge = (*returns)[move].edges_begin();
+                applyChanges(*polygon, chain, edge);
+            }
+            primitiveSink = polygon->size();
+        });
+    }});
+
+    primitives.push_back({"findEdgeInPoly", [](PrimitiveInputs& inputs){
+        auto edges = std::make_shared<std::vector<Segment_2>>();
+        for(int i = 0; i < queryCount; i++)
+            edges->push_back(inputs.polygon.edge(inputs.vertices[i]));
+
+        return std::function<void(int)>([&inputs, edges](int i){
+            primitiveSink = findEdgeInPoly(inputs.polygon, (*edges)[i]);
+        });
+    }});
+
+    // the transitions of localAnnealing: q, its neighbors p and r, and s after r, checked against the kd-tree of the vertices
+    primitives.push_back({"validityLocal", [](PrimitiveInputs& inputs){
+        auto annealing = std::make_shared<SimulatedAnnealing>(inputs.polygon, inputs.hullArea, 1, minimization, AnnealingType::local);
+        auto tree = std::make_shared<Tree>();
+        initializeTree(*tree, inputs.polygon);
+
+        return std::function<void(int)>([&inputs, annealing, tree](int i){
+            Polygon_2& polygon = inputs.polygon;
+            int q = inputs.vertices[i], n = polygon.size();
+            primitiveSink = annealing->validityLocal(polygon.vertex(q), polygon.vertex((q + 1) % n), polygon.vertex((q + 2) % n), polygon.vertex(q - 1), *tree);
+        });
+    }});
+
+    // the transitions of globalAnnealing: q between p and r, moved between s and t
+    primitives.push_back({"validityGlobal", [](PrimitiveInputs& inputs){
+        auto annealing = std::make_shared<SimulatedAnnealing>(inputs.polygon, inputs.hullArea, 1, minimization, AnnealingType::global);
+
+        return std::function<void(int)>([&inputs, annealing](int i){
+            Polygon_2& polygon = inputs.polygon;
+            int q = inputs.vertices[i], s = inputs.others[i], n = polygon.size();
+            primitiveSink = annealing->validityGlobal(polygon.vertex(q), polygon.vertex(q + 1), polygon.vertex(s), polygon.vertex(q - 1), polygon.vertex((s + 1) % n));
+        });
+    }});
+
+    primitives.push_back({"Pick", [](PrimitiveInputs& inputs){
+        return std::function<void(int)>([&inputs](int){
+            primitiveSink = Pick(inputs.polygon);
+        });
+    }});
+
+    return primitives;
+}
+
+// nanoseconds per call of the first batch of <call> that lasts at least <minTime> milliseconds
+double timeCalls(const std::function<void(int)>& call, double minTime)
+{
+    for(long calls = 2; ; calls *= 2)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for(long i = 0; i < calls; i++)
+            call(i % queryCount);
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        if(elapsed >= minTime * 1e6)
+            return elapsed / calls;
+    }
+}
+
+// least squares slope of log(ns/call) over log(size)
+double scalingSlope(const std::vector<std::pair<int, double>>& points)
+{
+    double n = points.size(), sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for(auto& point : points)
+    {
+        double x = log((double) point.first), y = log(point.second);
+        sx += x; sy += y; sxx += x * x; sxy += x * y;
+    }
+    return (n * sxy - sx * sy) / (n * sxx - sx * sx);
+}
+
+bool parseArgs(PrimitiveSettings& settings, int argc, char** argv)
+{
+    settings.sizes = {64, 256, 1024, 4096, 16384};
+    settings.repeat = 3;
+    settings.minTime = 100;
+    settings.maxCall = 100;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(i + 1 >= argc)
+            return false;
+
+        const char* value = argv[++i];
+        if(!strcmp(argv[i - 1], "-sizes"))
+        {
+            settings.sizes.clear();
+            for(const std::string& size : splitList(value))
+                settings.sizes.push_back(atoi(size.c_str()));
+        }
+        else if(!strcmp(argv[i - 1], "-repeat"))
+            settings.repeat = atoi(value);
+        else if(!strcmp(argv[i - 1], "-min-time"))
+            settings.minTime = atof(value);
+        else if(!strcmp(argv[i - 1], "-max-call"))
+            settings.maxCall = atof(value);
+        else if(!strcmp(argv[i - 1], "-only"))
+            settings.only = value;
+        else if(!strcmp(argv[i - 1], "-o"))
+            settings.outputFile = value;
+        else
+            return false;
+    }
+
+    std::sort(settings.sizes.begin(), settings.sizes.end());
+    return settings.repeat > 0 && settings.minTime > 0 && settings.maxCall > 0 && !settings.sizes.empty() && settings.sizes[0] >= 8;
+}
+
+int main(int argc, char** argv)
+{
+    PrimitiveSettings settings;
+    if(!parseArgs(settings, argc, argv))
+    {
+        std::cout << "./bench_primitives [-sizes 64,256,1024,4096,16384] [-repeat R] [-min-time ms] [-max-call ms] [-only <text>] [-o <results file>]" << std::endl;
+        return -1;
+    }
+
+    BenchResults results(settings.outputFile);
+    std::vector<Primitive> primitives = benchPrimitives();
+
+    std::vector<PrimitiveInputs> inputs;
+    for(int size : settings.sizes)
+        inputs.push_back(primitiveInputs(size));
+
+    printf("%-16s %8s %16s\n", "primitive", "size", "ns/call");
+
+    for(Primitive& primitive : primitives)
+    {
+        if(primitive.name.find(settings.only) == std::string::npos) continue;
+
+        std::vector<std::pair<int, double>> medians;
+        bool exhausted = false;
+
+        for(size_t s = 0; s < settings.sizes.size(); s++)
+        {
+            int size = settings.sizes[s];
+            if(exhausted)
+            {
+                printf("%-16s %8d %16s  skipped\n", primitive.name.c_str(), size, "-");
+                continue;
+            }
+
+            std::function<void(int)> call = primitive.prepare(inputs[s]);
+            std::string name = "primitive/" + primitive.name + "/" + std::to_string(size);
+
+            std::vector<double> samples;
+            for(int r = 0; r < settings.repeat; r++)
+            {
+                samples.push_back(timeCalls(call, settings.minTime));
+                results.record(name, samples.back(), "");
+            }
+
+            std::sort(samples.begin(), samples.end());
+            double median = samples[samples.size() / 2];
+            medians.push_back(std::make_pair(size, median));
+            exhausted = median > settings.maxCall * 1e6;
+
+            printf("%-16s %8d %16.1f\n", primitive.name.c_str(), size, median);
+            fflush(stdout);
+        }
+
+        if(medians.size() >= 2)
+            printf("%-16s %8s %16s  slope %.2f\n", primitive.name.c_str(), "", "", scalingSlope(medians));
+        else
+            printf("%-16s %8s %16s  slope -\n", primitive.name.c_str(), "", "");
+        fflush(stdout);
+    }
+
+    return 0;
+}
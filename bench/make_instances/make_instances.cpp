@@ -0,0 +1,174 @@
+#include "../SyntheticPoints.h"
+#include "../../DatasetBundle.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+/*
+    make_instances writes synthetic point sets (SyntheticPoints.h) in the input format of evaluate, for scaling studies:
+
+        # <family> point set
+        # parameters: {"area": "<convex hull area>"}
+        <index>\t<x>\t<y>      one line per point
+
+    The convex hull area is exact, a half integer area is written with its ".5".
+    Every instance is named <family>-<size>-<number>.instance, like the given instances, and is either written as a file
+    of the output directory (-o) or packed with the others into a bundle (-bundle) that evaluate reads with -i.
+
+    ./make_instances -families uniform,clustered,annulus -sizes 1000,100000 [-count K] [-seed S] (-o <directory> | -bundle <file>)
+*/
+
+struct InstanceSettings
+{
+    std::vector<std::string> families;
+    std::vector<int> sizes;
+    int count;              // instances of every family and size
+    unsigned long seed;
+    std::string directory;
+    std::string bundleFile;
+};
+
+struct InstanceSpec
+{
+    std::string family;
+    int size;
+    int number;
+};
+
+std::string instanceName(const InstanceSpec& spec)
+{
+    char name[128];
+    snprintf(name, sizeof(name), "%s-%07d-%d.instance", spec.family.c_str(), spec.size, spec.number);
+    return name;
+}
+
+// every instance gets its own seed, so adding families or sizes never changes the others
+IntPointList instancePoints(const InstanceSpec& spec, unsigned long seed)
+{
+    return syntheticPoints(spec.family, spec.size, seed + (unsigned long) spec.number * 7919);
+}
+
+std::string formatArea(long long twiceArea)
+{
+    return std::to_string(twiceArea / 2) + ((twiceArea % 2) ? ".5" : "");
+}
+
+void writeInstance(const std::string& path, const std::string& family, const IntPointList& points)
+{
+    std::ofstream out(path);
+    if(!out)
+        throw std::runtime_error("Could not create " + path);
+
+    out << "# " << family << " point set\n";
+    out << "# parameters: {\"area\": \"" << formatArea(twiceHullArea(points)) << "\"}\n";
+
+    std::string line;
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        line = std::to_string(i) + "\t" + std::to_string(points[i].x) + "\t" + std::to_string(points[i].y) + "\n";
+        out.write(line.data(), line.size());
+    }
+
+    if(!out)
+        throw std::runtime_error("Could not write " + path);
+}
+
+bool parseArgs(InstanceSettings& settings, int argc, char** argv)
+{
+    settings.count = 1;
+    settings.seed = 1;
+
+    for(int i = 1; i + 1 < argc; i += 2)
+    {
+        const char* flag = argv[i];
+        const char* value = argv[i + 1];
+
+        if(!strcmp(flag, "-families"))
+            settings.families = splitList(value);
+        else if(!strcmp(flag, "-sizes"))
+        {
+            for(const std::string& size : splitList(value))
+                settings.sizes.push_back(atoi(size.c_str()));
+        }
+        else if(!strcmp(flag, "-count"))
+            settings.count = atoi(value);
+        else if(!strcmp(flag, "-seed"))
+            settings.seed = strtoul(value, nullptr, 10);
+        else if(!strcmp(flag, "-o"))
+            settings.directory = value;
+        else if(!strcmp(flag, "-bundle"))
+            settings.bundleFile = value;
+        else
+            return false;
+    }
+
+    if(argc % 2 == 0 || settings.families.empty() || settings.sizes.empty() || settings.count < 1)
+        return false;
+
+    for(int size : settings.sizes)
+        if(size < 3) return false;
+
+    //checked here, before the directory or the bundle is created
+    for(const std::string& family : settings.families)
+        if(!isSyntheticFamily(family)) return false;
+
+    //exactly one of the outputs
+    return settings.directory.empty() != settings.bundleFile.empty();
+}
+
+int main(int argc, char** argv)
+{
+    InstanceSettings settings;
+    if(!parseArgs(settings, argc, argv))
+    {
+        std::cout << "./make_instances -families <family,...> -sizes <size,...> [-count K] [-seed S] (-o <directory> | -bundle <file>)" << std::endl;
+        std::cout << "families:";
+        for(const char* family : syntheticFamilies) std::cout << " " << family;
+        std::cout << std::endl;
+        return -1;
+    }
+
+    std::vector<InstanceSpec> specs;
+    for(const std::string& family : settings.families)
+        for(int size : settings.sizes)
+            for(int number = 0; number < settings.count; number++)
+                specs.push_back({family, size, number});
+
+    try
+    {
+        if(!settings.bundleFile.empty())
+        {
+            std::vector<std::string> names;
+            for(const InstanceSpec& spec : specs)
+                names.push_back(instanceName(spec));
+
+            //the bundle stores the area as an integer, like evaluate reads it from the files
+            writeBundle(settings.bundleFile, names, [&](size_t i, std::vector<int32_t>& coordinates, long& convexHullArea){
+                IntPointList points = instancePoints(specs[i], settings.seed);
+                convexHullArea = twiceHullArea(points) / 2;
+
+                coordinates.reserve(2 * points.size());
+                for(const IntPoint& point : points)
+                {
+                    coordinates.push_back(bundleCoordinate(point.x, names[i]));
+                    coordinates.push_back(bundleCoordinate(point.y, names[i]));
+                }
+            });
+        }
+        else
+        {
+            std::filesystem::create_directories(settings.directory);
+            for(const InstanceSpec& spec : specs)
+                writeInstance(settings.directory + "/" + instanceName(spec), spec.family, instancePoints(spec, settings.seed));
+        }
+    }
+    catch(const std::exception& error)
+    {
+        std::cout << error.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "Wrote " << specs.size() << " instances" << std::endl;
+    return 0;
+}
@@ -1,4 +1,6 @@
 #include"incr.h"
+#include "PolygonDump.h"
+#include "RandomSource.h"
 #include <climits>
 
 IncAlgo::IncAlgo(PointList& list, Initialization initialization, EdgeSelection edgeSelection) : PolygonGenerator(list)
@@ -42,10 +44,9 @@ int Edgeselection(Polygon_2 poly,Point p,std::vector<Segment_2> segs,int mode){
   int pos=0;
   Polygon_2 triangle;
   Segment_2 seg;
-  srand ( time(NULL) );
   int temp;
   if(segs.size()>2)
-    temp=rand()%segs.size();
+    temp=randomInt()%segs.size();
   else
     temp=0;
   if(mode==0)
@@ -117,9 +118,6 @@ Polygon_2 IncAlgo::generatePolygon(){
 
   std::vector <Point> vec;
   std::ostream_iterator< Point>  out( std::cout, "\n" );
-  std::ofstream os("test.wkt");
-  std::ofstream os1("test1.wkt");
-  std::ofstream os2("test12.wkt");
   PurpleEdges edges;
   std::string mode;
   if(initialization==0)
@@ -154,6 +152,8 @@ else   if(initialization==3)
   int pos=1;
   //for every other point ,find the purple edges,then the visible edges in the polygon between them and insert one to the polygon based on the algo.
   for(auto v1=vec.begin()+3;v1!=vec.end();++v1,++i){
+    if(cancelled())
+      break; //out of time, the points inserted so far are returned
     CGAL::convex_hull_2( poly.begin(), poly.end() ,std::back_inserter(hull));
     edges=CheckHull(hull,v1[0],pos);
 
@@ -177,7 +177,7 @@ else   if(initialization==3)
 
   
   
-  CGAL::IO::write_polygon_WKT(os2,poly);
+  dumpPolygon(poly,"incremental");
   return poly;
 
 
@@ -1,4 +1,7 @@
 # include "local.h"
+# include "PolygonDump.h"
+# include "Trace.h"
+# include "ConvergenceRecorder.h"
 
 // Constructor 
 LocalAlgo::LocalAlgo(Polygon_2& suboptimal,long convexHullArea ,double threshold, OptimizationType type, int length):PolygonOptimizer(suboptimal){
@@ -79,14 +82,24 @@ Polygon_2 LocalAlgo::optimalPolygon(){
   // COUT<<"INITIAL SCORE IS "<<score<<ENDL;
 
   std::list<areaChange> possibleChanges; // The list of the changes to be applied at the suboptimal polygon IN OR OUT?
+
+  ConvergenceCurve curve("local search", type);
+  long rounds=0;
+  curve.record(rounds,score);
   
   // while the improvement between the old and the new polygon is not negligable
   while(checkThreshold(thres,score,type)){
-    
+    TraceSpan round("loop", "local search round", true);
+    rounds++;
 
     // We iterate over the edges of the polygon
     for (auto eit=finalPoly.edges_begin();eit!=finalPoly.edges_end();eit++){
       
+      // If we are out of time we stop searching, finalPoly is always the best valid polygon so far
+      if(cancelled()){
+        break;
+      }
+
       auto eitAfter=eit; // the edge after 
       auto eitBefore=eit; // the edge before
       
@@ -123,7 +136,7 @@ Polygon_2 LocalAlgo::optimalPolygon(){
             long ar=abs(candPoly.area());
 
             // we check for validity and improvement
-            if(finalPoly.size()==candPoly.size() && areaImproves(ar,area,type) && candPoly.is_simple()){
+            if(finalPoly.size()==candPoly.size() && areaImproves(ar,area,type) && (COUNT_OP(localSimpleChecks), TIMED_CALL(timerLocalIsSimple, candPoly.is_simple()))){
 
              
               changePair ev; // we create a change pair to reprent the tuple (e,V)
@@ -146,6 +159,12 @@ Polygon_2 LocalAlgo::optimalPolygon(){
       }
     }
 
+    MARK_HIGH(localChanges, possibleChanges.size());
+
+    if(cancelled()){
+      break;
+    }
+
     // There is a chance that we found no elligalbe changes. We need to exit
     if(possibleChanges.empty()){
       score=thres;
@@ -165,6 +184,10 @@ Polygon_2 LocalAlgo::optimalPolygon(){
     
     //We iterate over the list of the potential changes we found before
     for(auto it=possibleChanges.begin();it!=possibleChanges.end();it++){
+      if(cancelled()){
+        break;
+      }
+
       Polygon_2 polyOnRoids=finalPoly;
       long areaEx=abs(finalPoly.area());
 
@@ -189,11 +212,12 @@ Polygon_2 LocalAlgo::optimalPolygon(){
         long ar=abs(polyOnRoids.area());
 
         // And we check for validity and improvement
-        if(sizeBefore==polyOnRoids.size() && areaImproves(ar,areaEx,type) && polyOnRoids.is_simple()){
+        if(sizeBefore==polyOnRoids.size() && areaImproves(ar,areaEx,type) && (COUNT_OP(localSimpleChecks), TIMED_CALL(timerLocalIsSimple, polyOnRoids.is_simple()))){
           
           improved=true; // we actually improved our polygon
           
           score=(double)ar/(double)(this->convexHullArea); // the new score
+          curve.record(rounds,score);
           
           if(type==maximization){ // We mark the changes we applied, based on what kind of improvement we want
             it->area=-1;
@@ -240,6 +264,7 @@ Polygon_2 LocalAlgo::optimalPolygon(){
 
   }
 
+  dumpPolygon(finalPoly,"local search");
   return finalPoly;
 }
 
@@ -5,6 +5,11 @@
 #include <cstdlib>
 #include <string.h>
 #include <filesystem>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <tuple>
+#include <random>
 
 #include "shared.h"
 
@@ -23,6 +28,17 @@
 #include "DefaultHandler.h"
 #include "ResultLogger.h"
 #include "SmartHandler.h"
+#include "DatasetBundle.h"
+#include "DatasetPipeline.h"
+#include "PolygonDump.h"
+#include "BatchExecutor.h"
+#include "RunJournal.h"
+#include "ResultCache.h"
+#include "RandomSource.h"
+#include "ResultSink.h"
+#include "Trace.h"
+#include "ConvergenceRecorder.h"
+#include "MetricsReporter.h"
   
 using std::cout;
 using std::endl;
@@ -55,6 +71,266 @@ double handleAlgorithm(AlgorithmHandler& handler, Combination combo, Optimizatio
     return 0.0;
 }
 
+// everything a run needs besides its instance, shared by the serial and the parallel evaluation
+struct EvaluationContext
+{
+    ResultLogger* logger;
+    RunJournal* journal;    // may be null
+    ResultCache* cache;     // may be null
+    ResultSink* sink;       // may be null
+    MetricsReporter* metrics;   // may be null
+    bool perfCounters;      // read the hardware counters of every run
+    int comboLimit;
+    int trials;
+    unsigned long seed;     // the trial seeds are derived from it
+    bool seeded;            // the seed was given or there are several trials, so cached results must match the trial seed
+
+    // scores of the (file, combination, objective) triples that still miss some of their trials
+    std::map<std::tuple<string, int, int>, std::vector<double>> trialScores;
+    std::mutex trialLock;
+};
+
+// the seed of one trial, mixed (splitmix64) from the base seed and the run, so it does not depend on the order the runs execute in
+unsigned long trialSeed(unsigned long seed, uint64_t fingerprint, const EvaluationTask& task)
+{
+    uint64_t state = seed ^ fingerprint;
+    state ^= ((uint64_t) task.combination << 48) ^ ((uint64_t) task.type << 40) ^ (uint64_t) task.trial;
+
+    state += 0x9e3779b97f4a7c15ULL;
+    state = (state ^ (state >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    state = (state ^ (state >> 27)) * 0x94d049bb133111ebULL;
+    return state ^ (state >> 31);
+}
+
+// runs one trial of a combination with one objective on the instance held by <handler>. Runs over 500ms per point get the worst score
+RunResult evaluateRun(AlgorithmHandler& handler, EvaluationContext& context, const EvaluationTask& task)
+{
+    int size = handler.getSize();
+    Combination combo = task.combination;
+    OptimizationType type = task.type;
+    std::string tag = combinationShortName(combo) + ((type == minimization) ? " min" : " max");
+    setPolygonDumpContext(task.dataset, tag);
+    setConvergenceContext(handler.getFilename(), tag, task.trial);
+
+    if(context.metrics != nullptr)
+        context.metrics->startRun();
+
+    unsigned long seed = trialSeed(context.seed, handler.getFingerprint(), task);
+
+    std::string cacheKey;
+    if(context.cache != nullptr)
+    {
+        cacheKey = context.cache->key(handler.getFingerprint(), combo, type, handler.parameterSignature(), context.seeded, seed);
+
+        RunResult cached;
+        Polygon_2 polygon;
+        if(context.cache->lookup(cacheKey, cached, polygon))
+        {
+            handler.setLastPolygon(polygon);
+            dumpPolygon(polygon, "cached");
+            return cached;
+        }
+    }
+
+    seedRandom(seed);
+
+    //a run gets 500ms per point, past that the algorithms stop early and the run scores as a cutoff
+    CancellationToken budget;
+    budget.setBudget(std::chrono::milliseconds(500L*size));
+    handler.setCancellation(&budget);
+    handler.resetTiming();
+    OpCounts operations = threadOpCounts;
+    MemorySnapshot memory = startMemoryRun();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    double score;
+    PerfCounts hardware;
+    {
+        TraceSpan span("run", tag, traceEnabled() ? traceArgument("file", handler.getFilename()) + "," + traceArgument("size", (long) size) + "," + traceArgument("trial", (long) task.trial) : "");
+        PerfCounterGroup* counters = context.perfCounters ? &threadPerfCounters() : nullptr;
+        if(counters != nullptr) counters->start();
+        score = handleAlgorithm(handler, combo, type);
+        if(counters != nullptr) hardware = counters->stop();
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+
+    handler.setCancellation(nullptr);
+
+    RunResult result;
+    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
+    result.cutoff = budget.expired() || (result.duration >= 500*size);
+    result.score = result.cutoff ? ((type == minimization) ? 1 : 0) : score;
+    result.cached = false;
+    result.generationTime = handler.getGenerationTime();
+    result.optimizationTime = handler.getOptimizationTime();
+    result.generationCpuTime = handler.getGenerationCpuTime();
+    result.optimizationCpuTime = handler.getOptimizationCpuTime();
+    result.operations = threadOpCounts - operations;
+    result.memory = finishMemoryRun(memory);
+    result.hardware = hardware;
+
+    //a cutoff depends on the speed of the machine, so only complete runs are cached
+    if(context.cache != nullptr && !result.cutoff)
+        context.cache->store(cacheKey, result, handler.getLastPolygon());
+
+    return result;
+}
+
+/*
+    Adds one trial to the trial statistics. Once every trial of the (file, combination, objective) triple is in,
+    their mean goes to the table as the score of the file, so with a single trial the table holds the plain scores.
+*/
+void collectTrial(EvaluationContext& context, const string& name, int size, Combination combo, OptimizationType type, double score, long duration)
+{
+    context.logger->updateTrial(size, combo, type, score, duration);
+
+    double mean = score;
+    if(context.trials > 1)
+    {
+        std::lock_guard<std::mutex> guard(context.trialLock);
+
+        auto key = std::make_tuple(name, (int) combo, (int) type);
+        std::vector<double>& scores = context.trialScores[key];
+        scores.push_back(score);
+
+        if((int) scores.size() < context.trials)
+            return;
+
+        mean = 0;
+        for(auto it = scores.begin(); it != scores.end(); ++it)
+            mean += *it;
+        mean /= scores.size();
+
+        context.trialScores.erase(key);
+    }
+
+    if(type == minimization)
+        context.logger->updateMinEntry(size, combo, mean);
+    else
+        context.logger->updateMaxEntry(size, combo, mean);
+}
+
+// logs the result of one run and appends it to the journal and the results file, if there are any
+void recordRun(EvaluationContext& context, const string& name, int size, const EvaluationTask& task, const RunResult& result)
+{
+    collectTrial(context, name, size, task.combination, task.type, result.score, result.duration);
+    context.logger->updateTiming(size, task.combination, result);
+    context.logger->updateOperations(name, size, task.combination, task.type, result);
+    context.logger->updateHardware(name, size, task.combination, task.type, result);
+
+    if(context.sink != nullptr)
+        context.sink->write({name, size, task.combination, task.type, task.trial, result});
+
+    if(context.metrics != nullptr)
+        context.metrics->finishRun(task.combination, task.type, size, result);
+
+    if(context.journal != nullptr)
+        context.journal->append({name, size, task.combination, task.type, task.trial, result});
+}
+
+void evaluateInstance(AlgorithmHandler& handler, EvaluationContext& context, const string& name, int fileId)
+{
+    int size = handler.getSize();
+
+    for(int i = 0; i < context.comboLimit; i++)
+    {
+        //progress goes to stdout without a flush, -metrics is the way to follow a long evaluation
+        cout << "Combination: " << combinationShortName((Combination) i) << "...\n";
+
+        //runs already in the journal were replayed into the logger before starting
+        for(OptimizationType type : {minimization, maximization})
+        {
+            for(int trial = 0; trial < context.trials; trial++)
+            {
+                if(context.journal != nullptr && context.journal->done(name, (Combination) i, type, trial))
+                {
+                    if(context.metrics != nullptr) context.metrics->skipRun();
+                    continue;
+                }
+
+                EvaluationTask task = {fileId, (Combination) i, type, trial, (long) size};
+                RunResult result = evaluateRun(handler, context, task);
+                recordRun(context, name, size, task, result);
+            }
+        }
+
+        // cout << "duration1: " << minResult.duration << endl << "  duration2: " << maxResult.duration << endl;
+
+        // if (minResult.cutoff || maxResult.cutoff)
+        //     cout << "hit cuttof" << endl;
+    }
+    cout << "\n";
+
+    if(context.metrics != nullptr)
+        context.metrics->finishFile();
+}
+
+AlgorithmHandler* makeHandler(std::string preprocess)
+{
+    if(preprocess == "smart")
+        return new SmartHandler();
+    else
+        return new DefaultHandler();
+}
+
+// runs every trial of every (file, combination, objective) triple as a separate task on <threads> worker threads
+void evaluateParallel(DatasetSource& source, EvaluationContext& context, ArgumentFlags& argFlags)
+{
+    BatchExecutor executor(argFlags.threads);
+    std::vector<Dataset> datasets;
+    executor.loadAll(source, datasets);
+
+    std::mutex outputLock;
+    std::vector<std::atomic<int>> remaining(datasets.size());
+    std::vector<int> filtered(datasets.size(), 0);
+    const int runsPerFile = context.comboLimit * 2 * context.trials;
+
+    for(auto it = datasets.begin(); it != datasets.end(); ++it)
+        dumpFileName(it->id, it->name);
+
+    //workers add their results to their own accumulators, folded into the table once all of them are done
+    context.logger->setConcurrent(true);
+
+    executor.run(
+        datasets,
+        context.comboLimit,
+        context.trials,
+        [&](const EvaluationTask& task)
+        {
+            bool done = context.journal != nullptr && context.journal->done(datasets[task.dataset].name, task.combination, task.type, task.trial);
+            if(done)
+            {
+                if(context.metrics != nullptr) context.metrics->skipRun();
+            }
+            else
+                remaining[task.dataset]++;
+
+            //a file whose runs are all in the journal gets no result to finish it
+            if(++filtered[task.dataset] == runsPerFile && remaining[task.dataset] == 0 && context.metrics != nullptr)
+                context.metrics->finishFile();
+            return !done;
+        },
+        [&]{return makeHandler(argFlags.preprocess);},
+        [&](AlgorithmHandler& handler, const EvaluationTask& task){return evaluateRun(handler, context, task);},
+        [&](const EvaluationTask& task, const RunResult& result)
+        {
+            const Dataset& dataset = datasets[task.dataset];
+            recordRun(context, dataset.name, dataset.size, task, result);
+
+            if(--remaining[task.dataset] == 0)
+            {
+                if(context.metrics != nullptr)
+                    context.metrics->finishFile();
+
+                std::lock_guard<std::mutex> guard(outputLock);
+                cout << "Finished file " << std::filesystem::path(datasets[task.dataset].name) << "\n";
+            }
+        }
+    );
+
+    context.logger->setConcurrent(false);
+}
+
 int main(int argc, char **argv)
 {
     ArgumentFlags argFlags;
@@ -64,68 +340,157 @@ int main(int argc, char **argv)
     if(argFlags.error)
     {
         cout << argFlags.errorMessage << endl;
-        cout << "./evaluate -i <point set path> -o <output file> -preprocess <optional>" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <output file> -preprocess <optional>" << endl;
+        cout << "./evaluate -i <point set path> -pack <bundle file>" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <partial results file> -shard <i>/<N>" << endl;
+        cout << "./evaluate -merge <partial results file> ... -o <output file>" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <output file> -journal <journal file> -resume" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <output file> -cache <cache directory>" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <output file> -trials <K> -seed <optional>" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <output file> -results <file.csv | file.jsonl>" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <output file> -stats" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <output file> -perfcounters" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <output file> -trace <trace file.json> -traceLoops <optional>" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <output file> -convergence <curves file.jsonl> -convergenceInterval <ms, optional>" << endl;
+        cout << "./evaluate -i <point set path | bundle file> -o <output file> -metrics <metrics file.prom> -metricsInterval <s, optional>" << endl;
         return -1;
     }
 
-    ResultLogger logger;
-    AlgorithmHandler *handler;
-    bool starting = true;
+    if(argFlags.merge)
+    {
+        ResultLogger merged;
+        for(auto it = argFlags.mergeFiles.begin(); it != argFlags.mergeFiles.end(); ++it)
+            merged.mergePartial(*it);
 
-    int comboLimit = (argFlags.useAnt) ? 7 : 6;
+        merged.printLogger(argFlags.outputFile);
+        return 0;
+    }
 
-    for (const auto & entry : std::filesystem::directory_iterator(argFlags.inputDirectory))
+    if(!argFlags.packFile.empty())
     {
-        cout << "Working on file " << entry.path() << "..." << endl;
-        if(starting)
-        {   
-            if(argFlags.preprocess == "smart")
-            {
-                handler = new SmartHandler(entry.path());
-            }
-            else
-            {
-                handler = new DefaultHandler(entry.path());
-            }
-                
-            starting = false;
-        } 
-        else
-            handler->resetFile(entry.path());
+        packDirectory(argFlags.inputDirectory, argFlags.packFile);
+        return 0;
+    }
+
+    if(!argFlags.dumpFile.empty())
+        openPolygonDump(argFlags.dumpFile);
+
+    if(!argFlags.traceFile.empty())
+        openTrace(argFlags.traceFile, argFlags.traceLoops);
+
+    if(!argFlags.convergenceFile.empty())
+        openConvergence(argFlags.convergenceFile, argFlags.convergenceInterval);
+
+    ResultLogger logger;
+    logger.setTrials(argFlags.trials);
+    logger.setOperationStats(argFlags.stats);
+
+    EvaluationContext context;
+    context.logger = &logger;
+    context.journal = nullptr;
+    context.cache = nullptr;
+    context.sink = nullptr;
+    context.metrics = nullptr;
+    context.perfCounters = false;
+    context.comboLimit = (argFlags.useAnt) ? 7 : 6;
+    context.trials = argFlags.trials;
+    context.seed = argFlags.seedGiven ? argFlags.seed : std::random_device{}();
+    context.seeded = argFlags.seedGiven || context.trials > 1;
+
+    if(context.trials > 1)
+        cout << "Running " << context.trials << " trials per run with seed " << context.seed << endl;
+
+    //without counters the evaluation goes on, the runs only miss their hardware counts
+    if(argFlags.perfCounters)
+    {
+        PerfCounterGroup& counters = threadPerfCounters();
+        if(!counters.available())
+            cout << "Hardware counters unavailable (" << counters.error() << "), running without -perfcounters" << endl;
+        else if(!counters.error().empty())
+            cout << "Some hardware counters are unavailable (" << counters.error() << ")" << endl;
+
+        context.perfCounters = counters.available();
+        logger.setHardwareStats(context.perfCounters);
+    }
 
-        int size = handler->getSize();
+    DatasetSource source(argFlags.inputDirectory);
 
-        for(int i = 0; i < comboLimit; i++)
+    if(!argFlags.cacheDirectory.empty())
+        context.cache = new ResultCache(argFlags.cacheDirectory);
+
+    //a resumed evaluation keeps the records of the runs it does not repeat
+    if(!argFlags.resultsFile.empty())
+        context.sink = new ResultSink(argFlags.resultsFile, argFlags.resume);
+
+    if(!argFlags.journalFile.empty())
+    {
+        RunJournal *journal = new RunJournal(argFlags.journalFile, "preprocess=" + argFlags.preprocess, argFlags.resume);
+        context.journal = journal;
+
+        //replay the finished runs and leave out the files that have nothing left to run
+        for(auto it = journal->records().begin(); it != journal->records().end(); ++it)
         {
-            cout << "Combination: " << combinationShortName((Combination) i) << "..." << endl;
+            if(it->combination >= context.comboLimit || it->trial >= context.trials) continue;
+            collectTrial(context, it->file, it->size, it->combination, it->type, it->result.score, it->result.duration);
+            context.logger->updateTiming(it->size, it->combination, it->result);
+        }
 
-            auto start = std::chrono::high_resolution_clock::now();
-            double minScore =  handleAlgorithm(*handler, (Combination) i, minimization);
-            auto stop = std::chrono::high_resolution_clock::now();
-            double maxScore =  handleAlgorithm(*handler, (Combination) i, maximization);
-            auto stop2 = std::chrono::high_resolution_clock::now();
+        if(!journal->records().empty())
+            cout << "Resuming from " << journal->records().size() << " journaled runs" << endl;
 
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-            auto duration2 = std::chrono::duration_cast<std::chrono::milliseconds>(stop2 - stop);
+        source.retain([&](const string& name){return !journal->doneAll(name, context.comboLimit, context.trials);});
+    }
 
-            minScore = (duration.count() < 500*size) ? minScore : 1;
-            maxScore = (duration2.count() < 500*size) ? maxScore : 0;
+    if(argFlags.shards > 0)
+    {
+        source.restrictToShard(argFlags.shard, argFlags.shards);
+        cout << "Shard " << argFlags.shard << "/" << argFlags.shards << ": " << source.count() << " files" << endl;
+    }
 
-            // cout << "duration1: " << duration.count() << endl << "  duration2: " << duration2.count() << endl;
+    if(!argFlags.metricsFile.empty())
+    {
+        context.metrics = new MetricsReporter(argFlags.metricsFile, argFlags.metricsInterval);
+        context.metrics->setWork(source.count(), (long) context.comboLimit * 2 * context.trials);
+    }
 
-            // if (minScore == 1 || maxScore == 0)
-            //     cout << "hit cuttof" << endl;
+    if(argFlags.threads > 1)
+    {
+        evaluateParallel(source, context, argFlags);
+    }
+    else
+    {
+        AlgorithmHandler *handler = makeHandler(argFlags.preprocess);
+        DatasetPipeline pipeline(source, 4);
+        Dataset dataset;
 
-            logger.updateEntry(size, (Combination) i, minScore, maxScore);
+        while(pipeline.next(dataset))
+        {
+            cout << "Working on file " << std::filesystem::path(dataset.name) << "..." << endl;
+            dumpFileName(dataset.id, dataset.name);
+            handler->resetDataset(dataset);
+            evaluateInstance(*handler, context, dataset.name, dataset.id);
         }
-        cout << endl;
+
+        delete handler;
     }
 
-    delete handler;
+    closePolygonDump();
+    closeTrace();
+    closeConvergence();
+    delete context.metrics;
+    delete context.journal;
+    delete context.cache;
+    delete context.sink;
 
     // cout << "Done with files" << endl;
 
-    logger.printLogger(argFlags.outputFile);
+    //a shard only holds part of the results, they become a table once every shard is merged with -merge
+    if(argFlags.shards > 0)
+        logger.writePartial(argFlags.outputFile);
+    else
+        logger.printLogger(argFlags.outputFile);
+
+    printScopedTimers(stdout);
 
     auto start = std::chrono::high_resolution_clock::now();
 
@@ -143,6 +508,19 @@ void handleArgs(ArgumentFlags& argFlags, int& argc, char**& argv)
 
     argFlags.preprocess = "default";
     argFlags.useAnt = false;
+    argFlags.threads = 0;
+    argFlags.trials = 1;
+    argFlags.seed = 0;
+    argFlags.seedGiven = false;
+    argFlags.merge = false;
+    argFlags.resume = false;
+    argFlags.stats = false;
+    argFlags.traceLoops = false;
+    argFlags.perfCounters = false;
+    argFlags.convergenceInterval = -1;
+    argFlags.metricsInterval = -1;
+    argFlags.shard = 0;
+    argFlags.shards = 0;
 
     for (int i = 1; i < argc; i++)
     {
@@ -156,8 +534,48 @@ void handleArgs(ArgumentFlags& argFlags, int& argc, char**& argv)
                     waitingForArg = 2;
                 else if (!strcmp(arg, "-preprocess"))
                     waitingForArg = 3;
+                else if (!strcmp(arg, "-pack"))
+                    waitingForArg = 4;
+                else if (!strcmp(arg, "-dump"))
+                    waitingForArg = 5;
+                else if (!strcmp(arg, "-threads"))
+                    waitingForArg = 6;
+                else if (!strcmp(arg, "-shard"))
+                    waitingForArg = 7;
                 else if (!strcmp(arg, "-useAnt"))
                     argFlags.useAnt = true;
+                else if (!strcmp(arg, "-journal"))
+                    waitingForArg = 8;
+                else if (!strcmp(arg, "-cache"))
+                    waitingForArg = 9;
+                else if (!strcmp(arg, "-trials"))
+                    waitingForArg = 10;
+                else if (!strcmp(arg, "-seed"))
+                    waitingForArg = 11;
+                else if (!strcmp(arg, "-results"))
+                    waitingForArg = 12;
+                else if (!strcmp(arg, "-stats"))
+                    argFlags.stats = true;
+                else if (!strcmp(arg, "-trace"))
+                    waitingForArg = 13;
+                else if (!strcmp(arg, "-traceLoops"))
+                    argFlags.traceLoops = true;
+                else if (!strcmp(arg, "-convergence"))
+                    waitingForArg = 14;
+                else if (!strcmp(arg, "-convergenceInterval"))
+                    waitingForArg = 15;
+                else if (!strcmp(arg, "-metrics"))
+                    waitingForArg = 16;
+                else if (!strcmp(arg, "-metricsInterval"))
+                    waitingForArg = 17;
+                else if (!strcmp(arg, "-perfcounters"))
+                    argFlags.perfCounters = true;
+                else if (!strcmp(arg, "-resume"))
+                    argFlags.resume = true;
+                else if (!strcmp(arg, "-merge"))
+                    argFlags.merge = true;
+                else if (argFlags.merge)
+                    argFlags.mergeFiles.push_back(string(arg));
                 break;
             case 1:
                 argFlags.inputDirectory = string(arg);
@@ -173,19 +591,123 @@ void handleArgs(ArgumentFlags& argFlags, int& argc, char**& argv)
                 argFlags.preprocess = string(arg);
                 waitingForArg = 0;
                 break;
+            case 4:
+                argFlags.packFile = string(arg);
+                waitingForArg = 0;
+                break;
+            case 5:
+                argFlags.dumpFile = string(arg);
+                waitingForArg = 0;
+                break;
+            case 6:
+                argFlags.threads = atoi(arg);
+                waitingForArg = 0;
+                break;
+            case 7:
+                if(sscanf(arg, "%d/%d", &argFlags.shard, &argFlags.shards) != 2 || argFlags.shards < 1 || argFlags.shard < 0 || argFlags.shard >= argFlags.shards){
+                    argFlags.error = true;
+                    argFlags.errorMessage = string("Shard must be <i>/<N> with 0 <= i < N");
+                    return;
+                }
+                waitingForArg = 0;
+                break;
+            case 8:
+                argFlags.journalFile = string(arg);
+                waitingForArg = 0;
+                break;
+            case 9:
+                argFlags.cacheDirectory = string(arg);
+                waitingForArg = 0;
+                break;
+            case 10:
+                argFlags.trials = std::max(atoi(arg), 1);
+                waitingForArg = 0;
+                break;
+            case 11:
+                argFlags.seed = strtoul(arg, nullptr, 10);
+                argFlags.seedGiven = true;
+                waitingForArg = 0;
+                break;
+            case 12:
+                argFlags.resultsFile = string(arg);
+                waitingForArg = 0;
+                break;
+            case 13:
+                argFlags.traceFile = string(arg);
+                waitingForArg = 0;
+                break;
+            case 14:
+                argFlags.convergenceFile = string(arg);
+                waitingForArg = 0;
+                break;
+            case 15:
+                argFlags.convergenceInterval = std::max(atol(arg), 0L);
+                waitingForArg = 0;
+                break;
+            case 16:
+                argFlags.metricsFile = string(arg);
+                waitingForArg = 0;
+                break;
+            case 17:
+                argFlags.metricsInterval = std::max(atol(arg), 1L);
+                waitingForArg = 0;
+                break;
         }
     }
 
+    //trials are independent, so unless told otherwise they run on every core
+    if(argFlags.threads < 1)
+        argFlags.threads = (argFlags.trials > 1) ? std::max((int) std::thread::hardware_concurrency(), 1) : 1;
+
+    if(argFlags.merge){
+        argFlags.error = argFlags.mergeFiles.empty() || waitingOutput;
+        argFlags.errorMessage = string("Must select partial results files and output file");
+        return;
+    }
+
     if(waitingInput){
         argFlags.error = true;
         argFlags.errorMessage = string("Must select input file");
         return;
     }
-    if(waitingOutput){
+    if(waitingOutput && argFlags.packFile.empty()){
         argFlags.error = true;
         argFlags.errorMessage = string("Must select output file");
         return;
     }
+    if(argFlags.resume && argFlags.journalFile.empty()){
+        argFlags.error = true;
+        argFlags.errorMessage = string("-resume needs a journal file (-journal)");
+        return;
+    }
+
+    if(argFlags.traceLoops && argFlags.traceFile.empty()){
+        argFlags.error = true;
+        argFlags.errorMessage = string("-traceLoops needs a trace file (-trace)");
+        return;
+    }
+
+    if(argFlags.convergenceInterval >= 0 && argFlags.convergenceFile.empty()){
+        argFlags.error = true;
+        argFlags.errorMessage = string("-convergenceInterval needs a convergence file (-convergence)");
+        return;
+    }
+    if(argFlags.convergenceInterval < 0)
+        argFlags.convergenceInterval = 10;
+
+    if(argFlags.metricsInterval >= 0 && argFlags.metricsFile.empty()){
+        argFlags.error = true;
+        argFlags.errorMessage = string("-metricsInterval needs a metrics file (-metrics)");
+        return;
+    }
+    if(argFlags.metricsInterval < 0)
+        argFlags.metricsInterval = 5;
+
+    if(argFlags.stats && !opCountersEnabled){
+        argFlags.error = true;
+        argFlags.errorMessage = string("-stats needs a build with operation counters (without EVALUATE_NO_OP_COUNTERS)");
+        return;
+    }
 
     argFlags.error = false;
     return;
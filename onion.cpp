@@ -1,5 +1,7 @@
 
 #include "onion.h"
+#include "PolygonDump.h"
+#include "RandomSource.h"
 #include <time.h>
 
 
@@ -9,13 +11,16 @@ OnionAlgo::OnionAlgo(PointList& list, int option) : PolygonGenerator(list){this-
 // Function that actually finds the polygon
 Polygon_2 OnionAlgo::generatePolygon(){
 
-  srand(time(0));
 
   std::vector<Point_2> points=list;
   std::vector<Polygon_2> allPolys;
 
   // We iterate over the points,creating convex Hulls, until there are less than 3  points left
   while(points.size()>2){
+    if(cancelled()){
+      return allPolys.empty() ? Polygon_2() : allPolys[0]; // out of time, return the outermost hull we have
+    }
+
     if(points.size()==3 && CGAL::collinear(points[0],points[1],points[2])){
       std::vector<Point_2>::iterator it = points.begin();
       points.erase(it+1); //Check for potential trouble
@@ -55,7 +60,7 @@ Polygon_2 OnionAlgo::generatePolygon(){
   int m=0;
 
   if(criterion==1){
-    m= rand()% allPolys[0].size();  // random m among all the available vertices of the first convex hull
+    m= randomInt()% allPolys[0].size();  // random m among all the available vertices of the first convex hull
   }else if(criterion==2){
     while(allPolys[0].vertex(m)!= *allPolys[0].left_vertex()){ //m is the vertex with the lowest x
       m++;
@@ -85,6 +90,9 @@ Polygon_2 OnionAlgo::generatePolygon(){
 
   // we iterate over the available convex Hulls
   for(int i =0;i<allPolys.size();i++){
+    if(cancelled()){
+      break; // out of time, return the hulls merged so far
+    }
 
     Point_2 mVertex;
     Point_2 mVertexPlus;
@@ -112,6 +120,9 @@ Polygon_2 OnionAlgo::generatePolygon(){
       // we have to ensure that k is visible from m
       // If not, we will have to choose a different m and therefore a different k(along with a different mPlus and lamda)
       while(!isVisible(mToK,allPolys[i+1])){
+        if(cancelled()){
+          return finalPoly;
+        }
         mMinus=m;
         mVertexMinus=mVertex;
 
@@ -169,6 +180,9 @@ Polygon_2 OnionAlgo::generatePolygon(){
         // There is a chance that the new lamda is not visble from neither m-1 nor m+1.
         //Thus we have to find a new m and repeat the above process
         while(!isVisible(newMPlusLamda,allPolys[i+1])){
+          if(cancelled()){
+            return finalPoly;
+          }
 
           m=nextIndex(m,finalPoly);
           mPlus=nextIndex(m,finalPoly);
@@ -535,6 +549,9 @@ Polygon_2 OnionAlgo::generatePolygon(){
 
       // we iterate over the left over points
       for(int j=0;j<points.size();j++){
+        if(cancelled()){
+          break; // out of time, the left over points that were not placed are dropped
+        }
         int indexClosePoint=-1;
         Point_2 closePoint=getClosestK(points[j],indexClosePoint,finalPoly); // we find the closest vertex of our "merged" polygon
 
@@ -548,6 +565,9 @@ Polygon_2 OnionAlgo::generatePolygon(){
 
           // And if it's visible from the closest point
           while(!isVisible(pointLine2,finalPoly)){
+            if(cancelled()){
+              return finalPoly;
+            }
             if(veit!=finalPoly.vertices_end()){
               veit++;
             }else{
@@ -567,6 +587,9 @@ Polygon_2 OnionAlgo::generatePolygon(){
             // Closest point -1 should be visible, if not we find a different closest
             // The smart choice is to look for the points that belong both in finalPoly and in the last ConvexHull
             while(!isVisible(lineFinalPoly,finalPoly)){
+              if(cancelled()){
+                return finalPoly;
+              }
               closePoint=getClosestK(points[j],indexClosePoint,allPolys[i]);
               veit=getVertexIt(closePoint,finalPoly);
               lineFinalPoly=Segment_2(*(veit-1),points[j]);
@@ -595,6 +618,7 @@ Polygon_2 OnionAlgo::generatePolygon(){
     }
   }
   
+  dumpPolygon(finalPoly,"onion");
   return finalPoly;
 }
 
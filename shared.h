@@ -10,6 +10,11 @@
 #include <CGAL/Search_traits_2.h>
 #include <iostream>
 
+#include "OpCounters.h"
+#include "MemoryStats.h"
+#include "ScopedTimers.h"
+#include "PerfCounters.h"
+
 typedef CGAL::Exact_predicates_inexact_constructions_kernel Kernel;
 typedef CGAL::Polygon_2<Kernel> Polygon_2;
 typedef CGAL::Point_2<Kernel> Point_2;
@@ -52,12 +57,60 @@ struct ArgumentFlags{
     std::string inputDirectory;
     std::string outputFile;
     std::string preprocess;
+    std::string packFile;
+    std::string dumpFile;
+    std::string journalFile;
+    std::string cacheDirectory;
+    std::string resultsFile;
+    std::string traceFile;
+    std::string convergenceFile;
+    std::string metricsFile;
+
+    std::vector<std::string> mergeFiles;
 
     bool error;
     bool useAnt;
+    bool merge;
+    bool resume;
+    bool stats;     // count the operations of every run, see OpCounters.h
+    bool traceLoops;    // trace the inner loops of the optimizers too
+    bool perfCounters;  // count cycles, instructions and misses of every run, see PerfCounters.h
+    long convergenceInterval;  // ms between the points of a convergence curve, -1 when not given
+    long metricsInterval;      // seconds between two updates of the metrics file, -1 when not given
+    int threads;
+    int trials;     // repetitions of every run, each with its own seed
+    unsigned long seed;
+    bool seedGiven;
+    int shard;      // index of the shard to run, from 0 to shards-1
+    int shards;     // number of shards, 0 runs the whole input
     std::string errorMessage;
 };
 
+// a parsed input instance
+struct Dataset{
+    int id;     // position of the instance in its input
+    std::string name;
+    PointList points;
+    int size;
+    long convexHullArea;
+    uint64_t fingerprint;   // hash of the points, see fingerprintPoints
+};
+
+// the outcome of one run of a combination with one objective
+struct RunResult{
+    double score;
+    long duration;  // milliseconds
+    bool cutoff;    // the run exceeded its time budget and got the worst score
+    bool cached;    // the result was read from the result cache instead of running
+    double generationTime;      // milliseconds spent generating the initial polygon
+    double optimizationTime;    // milliseconds spent optimizing it
+    double generationCpuTime;   // milliseconds of thread CPU time spent generating
+    double optimizationCpuTime; // milliseconds of thread CPU time spent optimizing
+    OpCounts operations;        // operations counted while running, none for cached results
+    MemoryUsage memory;         // memory used while running, none for cached results
+    PerfCounts hardware;        // hardware counters of the run with -perfcounters, none otherwise
+};
+
 struct testResults{
     double min_score;
     double max_score;